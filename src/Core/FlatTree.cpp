@@ -0,0 +1,84 @@
+// FlatTree.cpp
+// 结构数组形式的树拓扑实现文件
+
+#include "FlatTree.h"
+#include <algorithm>
+
+void FlatTree::reserve(size_t count)
+{
+    m_parent.reserve(count);
+    m_firstChild.reserve(count);
+    m_lastChild.reserve(count);
+    m_nextSibling.reserve(count);
+    m_depth.reserve(count);
+    m_subtreeSize.reserve(count);
+}
+
+void FlatTree::grow(int index)
+{
+    if (index < static_cast<int>(m_parent.size()))
+        return;
+    size_t count = index + 1;
+    m_parent.resize(count, NONE);
+    m_firstChild.resize(count, NONE);
+    m_lastChild.resize(count, NONE);
+    m_nextSibling.resize(count, NONE);
+    m_depth.resize(count, -1);
+    m_subtreeSize.resize(count, 0);
+}
+
+void FlatTree::addNode(int index, int parentIndex)
+{
+    grow(index);
+    m_parent[index] = parentIndex;
+    m_firstChild[index] = NONE;
+    m_lastChild[index] = NONE;
+    m_nextSibling[index] = NONE;
+
+    if (parentIndex != NONE)
+    {
+        if (m_lastChild[parentIndex] == NONE)
+            m_firstChild[parentIndex] = index;
+        else
+            m_nextSibling[m_lastChild[parentIndex]] = index;
+        m_lastChild[parentIndex] = index;
+        m_depth[index] = m_depth[parentIndex] + 1;
+    }
+    else
+    {
+        m_depth[index] = 0;
+    }
+
+    m_maxDepth = std::max(m_maxDepth, m_depth[index]);
+    m_sizesDirty = true;
+}
+
+void FlatTree::computeSubtreeSizes() const
+{
+    // 按深度分桶（计数排序），从最深层开始把子树大小累加到父节点
+    int count = static_cast<int>(m_depth.size());
+    std::vector<int> offsets(m_maxDepth + 2, 0);
+    for (int i = 0; i < count; ++i)
+    {
+        if (m_depth[i] >= 0)
+            offsets[m_depth[i] + 1]++;
+    }
+    for (int d = 0; d <= m_maxDepth; ++d)
+        offsets[d + 1] += offsets[d];
+
+    std::vector<int> byDepth(offsets.back());
+    for (int i = 0; i < count; ++i)
+    {
+        m_subtreeSize[i] = m_depth[i] >= 0 ? 1 : 0;
+        if (m_depth[i] >= 0)
+            byDepth[offsets[m_depth[i]]++] = i;
+    }
+
+    for (auto it = byDepth.rbegin(); it != byDepth.rend(); ++it)
+    {
+        int parentIndex = m_parent[*it];
+        if (parentIndex != NONE)
+            m_subtreeSize[parentIndex] += m_subtreeSize[*it];
+    }
+    m_sizesDirty = false;
+}
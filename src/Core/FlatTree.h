@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+class FlatTree;
+
+/**
+ * @brief 扁平树中的节点句柄
+ *
+ * 只包含树指针和节点索引，按值传递；所有查询都是对FlatTree列的一次下标访问。
+ * 索引为-1的句柄表示空节点，可直接用于条件判断。
+ */
+struct FlatNode
+{
+    const FlatTree *tree; // 所属扁平树
+    int index;            // 节点索引（-1表示空）
+
+    explicit operator bool() const { return index >= 0; }
+    bool operator==(const FlatNode &other) const { return index == other.index; }
+    bool operator!=(const FlatNode &other) const { return index != other.index; }
+
+    inline FlatNode parent() const;
+    inline FlatNode firstChild() const;
+    inline FlatNode lastChild() const;
+    inline FlatNode nextSibling() const;
+    inline int depth() const;
+    inline int subtreeSize() const;
+    inline bool isRoot() const;
+    inline bool isLeaf() const;
+};
+
+/**
+ * @brief 结构数组形式的树拓扑
+ *
+ * 按节点索引存放父节点、第一个子节点、最后一个子节点、下一个兄弟、深度和子树大小列。
+ * 节点加入时O(1)维护除子树大小以外的所有列；子树大小在节点增加后第一次查询时
+ * 按深度从深到浅统一计算一遍（O(N)）。深度从0开始（根节点为0）。
+ */
+class FlatTree
+{
+public:
+    static constexpr int NONE = -1; ///< 空索引
+
+    /**
+     * @brief 预留空间
+     * @param count 预计的最大节点索引+1
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief 加入一个节点，挂在父节点子列表的末尾
+     * @param index 节点索引
+     * @param parentIndex 父节点索引（NONE表示根）
+     */
+    void addNode(int index, int parentIndex);
+
+    /**
+     * @brief 列长度（最大节点索引+1）
+     */
+    size_t size() const { return m_parent.size(); }
+
+    /**
+     * @brief 索引处是否有节点
+     */
+    bool contains(int index) const { return index >= 0 && index < static_cast<int>(m_depth.size()) && m_depth[index] >= 0; }
+
+    /**
+     * @brief 获取节点句柄（索引处没有节点时返回空句柄）
+     */
+    FlatNode node(int index) const { return FlatNode{this, contains(index) ? index : NONE}; }
+
+    int parent(int index) const { return m_parent[index]; }
+    int firstChild(int index) const { return m_firstChild[index]; }
+    int lastChild(int index) const { return m_lastChild[index]; }
+    int nextSibling(int index) const { return m_nextSibling[index]; }
+    int depth(int index) const { return m_depth[index]; }
+
+    /**
+     * @brief 子树节点数（包括自身）
+     */
+    int subtreeSize(int index) const
+    {
+        if (m_sizesDirty)
+            computeSubtreeSizes();
+        return m_subtreeSize[index];
+    }
+
+    /**
+     * @brief 最大深度（根节点为0，空树为-1）
+     */
+    int maxDepth() const { return m_maxDepth; }
+
+private:
+    std::vector<int> m_parent;              // 父节点索引列
+    std::vector<int> m_firstChild;          // 第一个子节点索引列
+    std::vector<int> m_lastChild;           // 最后一个子节点索引列（用于O(1)追加）
+    std::vector<int> m_nextSibling;         // 下一个兄弟索引列
+    std::vector<int> m_depth;               // 深度列（-1表示该索引没有节点）
+    mutable std::vector<int> m_subtreeSize; // 子树大小列
+    mutable bool m_sizesDirty = false;      // 子树大小是否需要重新计算
+    int m_maxDepth = -1;                    // 最大深度
+
+    void grow(int index);
+    void computeSubtreeSizes() const;
+};
+
+inline FlatNode FlatNode::parent() const { return FlatNode{tree, tree->parent(index)}; }
+inline FlatNode FlatNode::firstChild() const { return FlatNode{tree, tree->firstChild(index)}; }
+inline FlatNode FlatNode::lastChild() const { return FlatNode{tree, tree->lastChild(index)}; }
+inline FlatNode FlatNode::nextSibling() const { return FlatNode{tree, tree->nextSibling(index)}; }
+inline int FlatNode::depth() const { return tree->depth(index); }
+inline int FlatNode::subtreeSize() const { return tree->subtreeSize(index); }
+inline bool FlatNode::isRoot() const { return tree->parent(index) == FlatTree::NONE; }
+inline bool FlatNode::isLeaf() const { return tree->firstChild(index) == FlatTree::NONE; }
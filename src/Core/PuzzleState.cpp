@@ -1,7 +1,51 @@
 #include "PuzzleState.h"
+#include <stdexcept>
 
 // PuzzleState类的实现
-// 由于PuzzleState类在头文件中已经实现了所有方法（内联实现），
-// 这个文件主要用于确保编译系统能够正确处理
+// 热路径上的访问和复制在头文件中内联实现，这里实现不常用或较长的方法
 
-// 如果需要添加非内联方法，可以在这里实现
+PuzzleState::PuzzleState(const std::vector<int> &values)
+{
+    if (values.size() > static_cast<size_t>(MAX_CELLS))
+        throw std::invalid_argument("Puzzle state has " + std::to_string(values.size()) +
+                                    " tiles, at most " + std::to_string(MAX_CELLS) + " are supported");
+    count = static_cast<uint8_t>(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        // 超出一个字节的值截断后可能恰好凑成合法状态，因此直接拒绝
+        if (values[i] < 0 || values[i] > 255)
+            throw std::invalid_argument("Puzzle state tile value " + std::to_string(values[i]) + " is out of range 0..255");
+        tiles[i] = static_cast<uint8_t>(values[i]);
+    }
+}
+
+PuzzleState::PuzzleState(int n)
+{
+    if (n < 0 || n * n > MAX_CELLS)
+        throw std::invalid_argument("Puzzle board size " + std::to_string(n) + " is not supported");
+    count = static_cast<uint8_t>(n * n);
+    std::memset(tiles, 0, count);
+}
+
+size_t PuzzleState::hash() const
+{
+    // 每次取8个字节做乘法混合，4x4棋盘只需两轮
+    const uint8_t *p = data();
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ count;
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, p + i, 8);
+        h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    if (i < count)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, p + i, count - i);
+        h = (h ^ word) * 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 29;
+    }
+    return static_cast<size_t>(h);
+}
@@ -2,25 +2,75 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <functional>
 
+/**
+ * @brief 拼图状态
+ *
+ * 每个格子用一个字节存储（格子值必须在0..255之间）。最多100个格子（10x10），全部内联在对象中，
+ * 任何棋盘尺寸的构造和复制都不分配内存；对象可平凡复制，状态列扩容时整块移动。
+ */
 class PuzzleState
 {
+public:
+    /// 最大格子数（10x10棋盘）
+    static constexpr int MAX_CELLS = 100;
+
 private:
-    std::vector<int> tiles;
+    uint8_t tiles[MAX_CELLS]; // 前count个字节有效
+    uint8_t count;            // 格子总数
 
 public:
-    PuzzleState() : tiles(9, 0) {} // 默认构造函数，3x3棋盘
-    PuzzleState(const std::vector<int> &tiles) : tiles(tiles) {}
-    PuzzleState(int n) : tiles(n * n, 0) {}
-    ~PuzzleState() {}
-
-    int size() const { return tiles.size(); }
-
-    int operator[](int index) const { return tiles[index]; }
-    
-    // 获取所有瓦片值
-    const std::vector<int>& getValues() const { return tiles; }
-    
-    // 设置瓦片值
-    void setValue(int index, int value) { tiles[index] = value; }
+    PuzzleState() : PuzzleState(3) {} // 默认构造函数，3x3棋盘
+
+    /**
+     * @brief 由格子值构造
+     * @throws std::invalid_argument 格子数超过MAX_CELLS或格子值不在0..255之间
+     */
+    PuzzleState(const std::vector<int> &values);
+
+    /**
+     * @brief 构造n*n的全0状态
+     * @throws std::invalid_argument n*n超过MAX_CELLS
+     */
+    PuzzleState(int n);
+
+    /**
+     * @brief 由已校验的字节构造（n不超过MAX_CELLS，由调用方保证）
+     */
+    PuzzleState(const uint8_t *values, int n) : count(static_cast<uint8_t>(n))
+    {
+        std::memcpy(tiles, values, n);
+    }
+
+    int size() const { return count; }
+
+    int operator[](int index) const { return data()[index]; }
+
+    // 获取格子数据（每格一个字节，共size()个）
+    const uint8_t *data() const { return tiles; }
+
+    // 设置瓦片值（0..255）
+    void setValue(int index, int value) { tiles[index] = static_cast<uint8_t>(value); }
+
+    bool operator==(const PuzzleState &other) const
+    {
+        return count == other.count && std::memcmp(data(), other.data(), count) == 0;
+    }
+    bool operator!=(const PuzzleState &other) const { return !(*this == other); }
+
+    // 计算状态的哈希值
+    size_t hash() const;
 };
+
+namespace std
+{
+    template <>
+    struct hash<PuzzleState>
+    {
+        size_t operator()(const PuzzleState &state) const { return state.hash(); }
+    };
+}
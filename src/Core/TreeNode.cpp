@@ -2,26 +2,15 @@
 // 树节点和树结构的实现文件
 
 #include "TreeNode.h"
+#include "../Parser/Solution.h"
 #include <algorithm>
 
 // TreeNode结构的实现
-TreeNode::TreeNode(int idx, const PuzzleState &st, int g_val, int h_val, TreeNode *parent_ptr)
-    : index(idx), state(st), g(g_val), h(h_val), f(g_val + h_val),
-      parent(parent_ptr), position(0, 0) {}
+TreeNode::TreeNode(int idx, TreeNode *parent_ptr)
+    : index(idx), parent(parent_ptr), firstChild(nullptr), nextSibling(nullptr), position(0, 0) {}
 
-TreeNode::~TreeNode()
-{
-    for (TreeNode *child : children)
-    {
-        delete child;
-    }
-}
-
-void TreeNode::addChild(TreeNode *child)
-{
-    children.push_back(child);
-    child->parent = this;
-}
+TreeNode::TreeNode()
+    : index(-1), parent(nullptr), firstChild(nullptr), nextSibling(nullptr), position(0, 0) {}
 
 bool TreeNode::isRoot() const
 {
@@ -30,7 +19,7 @@ bool TreeNode::isRoot() const
 
 bool TreeNode::isLeaf() const
 {
-    return children.empty();
+    return firstChild == nullptr;
 }
 
 int TreeNode::getDepth() const
@@ -47,35 +36,99 @@ int TreeNode::getDepth() const
 
 std::vector<int> TreeNode::getPathToRoot() const
 {
-    std::vector<int> path;
+    // 先数出深度再从尾部倒序填入，只分配一次且不需要反转
+    std::vector<int> path(getDepth() + 1);
     const TreeNode *current = this;
-    while (current != nullptr)
+    for (auto it = path.rbegin(); it != path.rend(); ++it)
     {
-        path.push_back(current->index);
+        *it = current->index;
         current = current->parent;
     }
-    std::reverse(path.begin(), path.end());
     return path;
 }
 
 // Tree类的实现
-Tree::Tree() : root(nullptr) {}
+Tree::Tree(const ISolution *source, size_t capacity)
+    : root(nullptr), solution(source), blockSize(capacity > 0 ? capacity : NODE_BLOCK_SIZE)
+{
+    flat.reserve(capacity);
+}
 
-Tree::~Tree()
+TreeNode *Tree::createNode(int idx, TreeNode *parent_ptr)
 {
-    if (root)
+    size_t blockIndex = idx / blockSize;
+    if (blockIndex >= blocks.size())
+    {
+        blocks.resize(blockIndex + 1);
+    }
+    if (!blocks[blockIndex])
+    {
+        blocks[blockIndex] = std::make_unique<TreeNode[]>(blockSize);
+    }
+
+    TreeNode *node = &blocks[blockIndex][idx % blockSize];
+    node->index = idx;
+    node->parent = parent_ptr;
+    node->firstChild = nullptr;
+    node->nextSibling = nullptr;
+    if (parent_ptr)
     {
-        delete root;
+        // FlatTree记录父节点当前的最后一个子节点，新节点接在它后面，子节点顺序与创建顺序一致
+        int lastChild = flat.lastChild(parent_ptr->index);
+        if (lastChild == FlatTree::NONE)
+            parent_ptr->firstChild = node;
+        else
+            allNodes[lastChild]->nextSibling = node;
     }
+    flat.addNode(idx, parent_ptr ? parent_ptr->index : FlatTree::NONE);
+    pathIndex.reset();
+
+    if (idx >= static_cast<int>(allNodes.size()))
+    {
+        allNodes.resize(idx + 1, nullptr);
+    }
+    allNodes[idx] = node;
+    return node;
+}
+
+const PuzzleState &Tree::getState(int index) const
+{
+    return solution->getState(index);
+}
+
+int Tree::getG(int index) const
+{
+    return solution->getG(index);
+}
+
+int Tree::getH(int index) const
+{
+    return solution->getH(index);
+}
+
+int Tree::getF(int index) const
+{
+    return solution->getF(index);
+}
+
+void Tree::addMergedEdge(int from, int to)
+{
+    mergedEdges.emplace_back(from, to);
 }
 
 void Tree::setRoot(TreeNode *node)
 {
     root = node;
-    if (node)
+    pathIndex.reset();
+}
+
+const TreePathIndex &Tree::getPathIndex() const
+{
+    if (!pathIndex)
     {
-        collectAllNodes(node);
+        pathIndex = std::make_unique<TreePathIndex>(flat, root ? root->index : FlatTree::NONE);
     }
+    return *pathIndex;
 }
 
 TreeNode *Tree::getRoot() const
@@ -106,44 +159,6 @@ int Tree::getMaxDepth() const
 {
     if (!root)
         return 0;
-    return calculateMaxDepth(root);
-}
-
-void Tree::collectAllNodes(TreeNode *node)
-{
-    if (!node)
-        return;
-
-    // 确保allNodes有足够的空间
-    if (node->index >= static_cast<int>(allNodes.size()))
-    {
-        allNodes.resize(node->index + 1, nullptr);
-    }
-
-    allNodes[node->index] = node;
-
-    for (TreeNode *child : node->children)
-    {
-        collectAllNodes(child);
-    }
+    // 深度列在建树时已维护，这里按层数返回（根节点算第1层）
+    return flat.maxDepth() + 1;
 }
-
-int Tree::calculateMaxDepth(TreeNode *node) const
-{
-    if (node->children.empty())
-    {
-        return 1;
-    }
-
-    int maxDepth = 0;
-    for (TreeNode *child : node->children)
-    {
-        int childDepth = calculateMaxDepth(child);
-        if (childDepth > maxDepth)
-        {
-            maxDepth = childDepth;
-        }
-    }
-
-    return maxDepth + 1;
-}
\ No newline at end of file
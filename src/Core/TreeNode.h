@@ -1,44 +1,40 @@
 #pragma once
 
 #include "PuzzleState.h"
+#include "FlatTree.h"
+#include "TreePathIndex.h"
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <memory>
+#include <utility>
+
+class ISolution;
 
 /**
  * @brief 树节点结构，表示搜索树中的一个状态节点
+ *
+ * 节点不复制状态和代价，只保存在Solution中的索引；状态和g/h/f通过Tree按索引从Solution读取。
+ * 子节点以第一个子节点/下一个兄弟的指针串在节点池中（与FlatTree的列相同），节点本身不分配任何堆内存。
  */
 struct TreeNode
 {
-    int index;                        // 在Solution中的索引
-    PuzzleState state;                // 状态数据
-    int g;                            // 实际代价
-    int h;                            // 启发式代价
-    int f;                            // 总代价 (f = g + h)
-    TreeNode *parent;                 // 父节点指针
-    std::vector<TreeNode *> children; // 子节点列表
-    sf::Vector2f position;            // 布局位置
-
-    /**
-     * @brief 构造函数
-     * @param idx 节点索引
-     * @param st 状态数据
-     * @param g_val 实际代价
-     * @param h_val 启发式代价
-     * @param parent_ptr 父节点指针
-     */
-    TreeNode(int idx, const PuzzleState &st, int g_val, int h_val, TreeNode *parent_ptr = nullptr);
+    int index;             // 在Solution中的索引
+    TreeNode *parent;      // 父节点指针
+    TreeNode *firstChild;  // 第一个子节点（nullptr表示叶子）
+    TreeNode *nextSibling; // 下一个兄弟节点
+    sf::Vector2f position; // 布局位置
 
     /**
-     * @brief 析构函数，递归删除所有子节点
+     * @brief 默认构造函数，用于预分配节点池中的空槽位（index为-1）
      */
-    ~TreeNode();
+    TreeNode();
 
     /**
-     * @brief 添加子节点
-     * @param child 要添加的子节点
+     * @brief 构造函数
+     * @param idx 节点索引
+     * @param parent_ptr 父节点指针
      */
-    void addChild(TreeNode *child);
+    TreeNode(int idx, TreeNode *parent_ptr = nullptr);
 
     /**
      * @brief 判断是否为根节点
@@ -67,27 +63,80 @@ struct TreeNode
 
 /**
  * @brief 树结构类，管理整个搜索树
+ *
+ * 节点由树统一持有，存放在按节点索引寻址的节点池中：索引i的节点位于第i/blockSize块的第i%blockSize个槽位。
+ * 已知节点数时整棵树就是一块连续内存，按索引遍历即按内存顺序访问；增量构建时按固定大小逐块追加，
+ * 已创建节点的地址不会改变。析构时逐块整体释放，不会因为很深的链而递归。
+ * 创建节点时同步维护FlatTree，布局、渲染和统计通过FlatNode句柄访问拓扑和深度。
+ * 状态和g/h/f不复制到节点中，而是按索引从构建该树的Solution读取，Solution必须比树活得久。
  */
 class Tree
 {
+public:
+    /// 未指定容量时每块的节点数
+    static constexpr size_t NODE_BLOCK_SIZE = 4096;
+
 private:
-    TreeNode *root;                   // 根节点
-    std::vector<TreeNode *> allNodes; // 所有节点的列表（用于快速访问）
+    TreeNode *root;                                  // 根节点
+    const ISolution *solution;                       // 提供状态和代价的解决方案（不持有）
+    std::vector<TreeNode *> allNodes;                // 所有节点的列表（按索引，用于快速访问）
+    std::vector<std::unique_ptr<TreeNode[]>> blocks; // 节点池
+    size_t blockSize;                                // 每块的节点数
+    FlatTree flat;                                   // 结构数组形式的拓扑（父/子/兄弟/深度/子树大小）
+    std::vector<std::pair<int, int>> mergedEdges;    // DAG视图中树边以外的边（父索引, 子索引）
+    mutable std::unique_ptr<TreePathIndex> pathIndex; // 祖先/路径查询索引（按需构建，树变化后失效）
 
 public:
     /**
      * @brief 构造函数
+     * @param source 提供状态和代价的解决方案（不持有）
+     * @param capacity 预计的最大节点索引+1，非0时所有节点放在同一块连续内存中
+     */
+    explicit Tree(const ISolution *source = nullptr, size_t capacity = 0);
+
+    Tree(const Tree &) = delete;
+    Tree &operator=(const Tree &) = delete;
+
+    /**
+     * @brief 在节点池中创建节点并挂到父节点子节点链的末尾
+     * @param idx 节点索引（决定所在槽位，同一索引只能创建一次）
+     * @param parent_ptr 父节点指针（nullptr表示不挂到任何节点下）
+     * @return 新节点指针，在树的生命周期内保持不变
+     */
+    TreeNode *createNode(int idx, TreeNode *parent_ptr = nullptr);
+
+    /**
+     * @brief 获取提供状态和代价的解决方案
+     */
+    const ISolution *getSolution() const { return solution; }
+
+    /**
+     * @brief 获取节点状态（从Solution读取，不在节点中保存副本）
+     * @param index 节点索引
      */
-    Tree();
+    const PuzzleState &getState(int index) const;
 
     /**
-     * @brief 析构函数
+     * @brief 获取节点的g值
+     * @param index 节点索引
+     */
+    int getG(int index) const;
+
+    /**
+     * @brief 获取节点的h值
+     * @param index 节点索引
      */
-    ~Tree();
+    int getH(int index) const;
+
+    /**
+     * @brief 获取节点的f值
+     * @param index 节点索引
+     */
+    int getF(int index) const;
 
     /**
      * @brief 设置根节点
-     * @param node 根节点
+     * @param node 根节点，必须由createNode创建
      */
     void setRoot(TreeNode *node);
 
@@ -111,28 +160,45 @@ public:
     const std::vector<TreeNode *> &getAllNodes() const;
 
     /**
-     * @brief 获取树的大小（节点数量）
-     * @return 节点数量
+     * @brief 添加一条树边以外的边（DAG视图中合并相同状态后产生的额外入边）
+     * @param from 起点节点索引
+     * @param to 终点节点索引
      */
-    size_t size() const;
+    void addMergedEdge(int from, int to);
 
     /**
-     * @brief 获取树的最大深度
-     * @return 最大深度
+     * @brief 获取树边以外的边
      */
-    int getMaxDepth() const;
+    const std::vector<std::pair<int, int>> &getMergedEdges() const { return mergedEdges; }
 
-private:
     /**
-     * @brief 递归收集所有节点
-     * @param node 当前节点
+     * @brief 获取结构数组形式的拓扑
      */
-    void collectAllNodes(TreeNode *node);
+    const FlatTree &getFlatTree() const { return flat; }
 
     /**
-     * @brief 递归计算最大深度
-     * @param node 当前节点
-     * @return 子树的最大深度
+     * @brief 获取节点的扁平句柄
+     * @param index 节点索引
+     * @return 节点句柄，节点不存在时为空句柄
      */
-    int calculateMaxDepth(TreeNode *node) const;
+    FlatNode getFlatNode(int index) const { return flat.node(index); }
+
+    /**
+     * @brief 获取祖先、LCA和路径查询索引
+     *
+     * 第一次调用时构建（O(N)），之后直到树再增加节点或更换根节点前都复用同一个索引。
+     */
+    const TreePathIndex &getPathIndex() const;
+
+    /**
+     * @brief 获取树的大小（节点数量）
+     * @return 节点数量
+     */
+    size_t size() const;
+
+    /**
+     * @brief 获取树的最大深度
+     * @return 最大深度
+     */
+    int getMaxDepth() const;
 };
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "TreePathIndex.h"
+#include <algorithm>
+#include <array>
+
+namespace
+{
+    // De Bruijn序列求最低位1的位置，不依赖编译器内建函数
+    constexpr uint64_t DE_BRUIJN = 0x03F79D71B4CB0A89ull;
+
+    constexpr std::array<int, 64> makeBitTable()
+    {
+        std::array<int, 64> table{};
+        for (int i = 0; i < 64; ++i)
+            table[((uint64_t(1) << i) * DE_BRUIJN) >> 58] = i;
+        return table;
+    }
+
+    constexpr std::array<int, 64> BIT_TABLE = makeBitTable();
+
+    int lowestBit(uint64_t mask)
+    {
+        return BIT_TABLE[((mask & (~mask + 1)) * DE_BRUIJN) >> 58];
+    }
+}
+
+TreePathIndex::TreePathIndex(const FlatTree &flat, int root)
+    : m_flat(&flat)
+{
+    int count = static_cast<int>(flat.size());
+    m_tin.assign(count, -1);
+    m_tout.assign(count, -1);
+    if (!flat.contains(root))
+        return;
+
+    // 沿firstChild/nextSibling/parent列做先序遍历，不需要栈
+    m_order.reserve(count);
+    m_depths.reserve(count);
+    int node = root;
+    while (node != FlatTree::NONE)
+    {
+        m_tin[node] = static_cast<int>(m_order.size());
+        m_order.push_back(node);
+        m_depths.push_back(flat.depth(node));
+        if (flat.firstChild(node) != FlatTree::NONE)
+        {
+            node = flat.firstChild(node);
+            continue;
+        }
+
+        // 叶子：向上结束各层子树，直到找到下一个兄弟
+        while (true)
+        {
+            m_tout[node] = static_cast<int>(m_order.size());
+            if (node == root)
+            {
+                node = FlatTree::NONE;
+                break;
+            }
+            if (flat.nextSibling(node) != FlatTree::NONE)
+            {
+                node = flat.nextSibling(node);
+                break;
+            }
+            node = flat.parent(node);
+        }
+    }
+
+    // 块内：第i位为1表示该位置在处理到i时仍在单调栈中（栈中元素是各后缀的最小值）
+    int length = static_cast<int>(m_order.size());
+    m_masks.resize(length);
+    int stack[BLOCK];
+    for (int start = 0; start < length; start += BLOCK)
+    {
+        int end = std::min(start + BLOCK, length);
+        int top = 0;
+        uint64_t mask = 0;
+        for (int i = start; i < end; ++i)
+        {
+            while (top > 0 && m_depths[stack[top - 1]] > m_depths[i])
+            {
+                mask &= ~(uint64_t(1) << (stack[--top] - start));
+            }
+            stack[top++] = i;
+            mask |= uint64_t(1) << (i - start);
+            m_masks[i] = mask;
+        }
+    }
+
+    // 块间：稀疏表存放连续2^j个块中的最小值位置
+    int blocks = (length + BLOCK - 1) / BLOCK;
+    m_log2.assign(blocks + 1, 0);
+    for (int i = 2; i <= blocks; ++i)
+        m_log2[i] = m_log2[i / 2] + 1;
+
+    m_sparse.emplace_back(blocks);
+    for (int b = 0; b < blocks; ++b)
+        m_sparse[0][b] = blockMin(b * BLOCK, std::min((b + 1) * BLOCK, length) - 1);
+    for (int j = 1; (1 << j) <= blocks; ++j)
+    {
+        const std::vector<int> &prev = m_sparse[j - 1];
+        std::vector<int> level(blocks - (1 << j) + 1);
+        for (size_t b = 0; b < level.size(); ++b)
+            level[b] = minPosition(prev[b], prev[b + (1 << (j - 1))]);
+        m_sparse.push_back(std::move(level));
+    }
+}
+
+int TreePathIndex::blockMin(int l, int r) const
+{
+    // r处的栈中位于l及之后的最低位，就是[l, r]中最左的最小值
+    int start = l - l % BLOCK;
+    return start + lowestBit(m_masks[r] & (~uint64_t(0) << (l - start)));
+}
+
+int TreePathIndex::rangeMin(int l, int r) const
+{
+    int lb = l / BLOCK, rb = r / BLOCK;
+    if (lb == rb)
+        return blockMin(l, r);
+
+    int best = minPosition(blockMin(l, lb * BLOCK + BLOCK - 1), blockMin(rb * BLOCK, r));
+    if (lb + 1 < rb)
+    {
+        int j = m_log2[rb - lb - 1];
+        best = minPosition(best, minPosition(m_sparse[j][lb + 1], m_sparse[j][rb - (1 << j)]));
+    }
+    return best;
+}
+
+int TreePathIndex::lca(int u, int v) const
+{
+    if (!contains(u) || !contains(v))
+        return FlatTree::NONE;
+    if (u == v)
+        return u;
+
+    int a = std::min(m_tin[u], m_tin[v]);
+    int b = std::max(m_tin[u], m_tin[v]);
+    return m_flat->parent(m_order[rangeMin(a + 1, b)]);
+}
+
+int TreePathIndex::distance(int u, int v) const
+{
+    int ancestor = lca(u, v);
+    if (ancestor == FlatTree::NONE)
+        return -1;
+    return m_flat->depth(u) + m_flat->depth(v) - 2 * m_flat->depth(ancestor);
+}
+
+std::vector<int> TreePathIndex::pathToRoot(int index) const
+{
+    if (!contains(index))
+        return {};
+
+    // 长度由深度直接得到，从节点向上倒序填入
+    std::vector<int> path(m_flat->depth(index) - m_depths[0] + 1);
+    for (auto it = path.rbegin(); it != path.rend(); ++it)
+    {
+        *it = index;
+        index = m_flat->parent(index);
+    }
+    return path;
+}
+
+std::vector<int> TreePathIndex::path(int from, int to) const
+{
+    int ancestor = lca(from, to);
+    if (ancestor == FlatTree::NONE)
+        return {};
+
+    int up = m_flat->depth(from) - m_flat->depth(ancestor);
+    int down = m_flat->depth(to) - m_flat->depth(ancestor);
+    std::vector<int> path(up + down + 1);
+    for (int i = 0; i < up; ++i, from = m_flat->parent(from))
+        path[i] = from;
+    path[up] = ancestor;
+    for (int i = up + down; i > up; --i, to = m_flat->parent(to))
+        path[i] = to;
+    return path;
+}
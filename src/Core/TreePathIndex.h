@@ -0,0 +1,84 @@
+#pragma once
+
+#include "FlatTree.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 树上的祖先、最近公共祖先（LCA）和路径查询索引
+ *
+ * 构建时对树做一次先序遍历，记录每个节点的进入时间和子树结束时间：
+ * 祖先判断只需比较两个时间区间（O(1)）。
+ * 对于不同的节点u、v（tin[u] < tin[v]），先序序列(tin[u], tin[v]]中深度最小的节点的父节点就是LCA，
+ * 因此LCA归结为先序深度序列上的区间最小值查询：序列按64个元素分块，
+ * 块间用稀疏表，块内用单调栈位掩码，查询O(1)，额外空间O(N)。
+ * 索引只反映构建时的树，树增长后需要重新构建（见Tree::getPathIndex）。
+ */
+class TreePathIndex
+{
+public:
+    /**
+     * @brief 构造函数，为以root为根的树建立索引
+     * @param flat 树拓扑
+     * @param root 根节点索引
+     */
+    TreePathIndex(const FlatTree &flat, int root);
+
+    /**
+     * @brief 节点是否在索引中
+     */
+    bool contains(int index) const { return index >= 0 && index < static_cast<int>(m_tin.size()) && m_tin[index] >= 0; }
+
+    /**
+     * @brief 索引中的节点数
+     */
+    size_t size() const { return m_order.size(); }
+
+    /**
+     * @brief ancestor是否为node的祖先（节点是自身的祖先）
+     */
+    bool isAncestor(int ancestor, int node) const
+    {
+        return contains(ancestor) && contains(node) &&
+               m_tin[ancestor] <= m_tin[node] && m_tin[node] < m_tout[ancestor];
+    }
+
+    /**
+     * @brief 最近公共祖先
+     * @return LCA索引，任一节点不在索引中时返回FlatTree::NONE
+     */
+    int lca(int u, int v) const;
+
+    /**
+     * @brief 两节点之间的边数
+     * @return 距离，任一节点不在索引中时返回-1
+     */
+    int distance(int u, int v) const;
+
+    /**
+     * @brief 从根节点到节点的路径（包括两端）
+     */
+    std::vector<int> pathToRoot(int index) const;
+
+    /**
+     * @brief 从from经过LCA到to的路径（包括两端）
+     * @return 节点索引序列，任一节点不在索引中时返回空
+     */
+    std::vector<int> path(int from, int to) const;
+
+private:
+    static constexpr int BLOCK = 64; // 区间最小值查询的分块大小
+
+    const FlatTree *m_flat;                 // 树拓扑
+    std::vector<int> m_tin;                 // 先序进入时间（-1表示不在索引中）
+    std::vector<int> m_tout;                // 子树结束时间（不含）
+    std::vector<int> m_order;               // 先序序列（时间 -> 节点）
+    std::vector<int> m_depths;              // 先序序列上的深度
+    std::vector<uint64_t> m_masks;          // 块内单调栈位掩码
+    std::vector<std::vector<int>> m_sparse; // 块最小值位置的稀疏表
+    std::vector<int> m_log2;                // 块数的以2为底对数（向下取整）
+
+    int minPosition(int a, int b) const { return m_depths[b] < m_depths[a] ? b : a; }
+    int blockMin(int l, int r) const;
+    int rangeMin(int l, int r) const;
+};
@@ -0,0 +1,48 @@
+// Zobrist.cpp
+// 拼图状态Zobrist哈希的键表
+
+#include "Zobrist.h"
+#include <array>
+
+namespace
+{
+    using KeyTable = std::array<uint64_t, Zobrist::MAX_CELLS * Zobrist::MAX_CELLS>;
+
+    // splitmix64：固定种子生成键表，保证不同运行之间哈希一致
+    KeyTable makeTable()
+    {
+        KeyTable table{};
+        uint64_t seed = 0x4E50757A7A6C6521ull;
+        for (uint64_t &value : table)
+        {
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            value = z ^ (z >> 31);
+        }
+        return table;
+    }
+
+    const KeyTable &table()
+    {
+        static const KeyTable keys = makeTable();
+        return keys;
+    }
+}
+
+namespace Zobrist
+{
+    uint64_t key(int cell, int tile)
+    {
+        return table()[cell * MAX_CELLS + tile];
+    }
+
+    uint64_t hash(const uint8_t *tiles, int cells)
+    {
+        const KeyTable &keys = table();
+        uint64_t h = 0;
+        for (int i = 0; i < cells; ++i)
+            h ^= keys[i * MAX_CELLS + tiles[i]];
+        return h;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief 拼图状态的Zobrist哈希
+ *
+ * 每个(格子, 瓦片值)对应一个固定的64位随机键，状态哈希是所有格子键的异或。
+ * 空格移动一步只改变两个格子，因此子状态的哈希可以由父状态哈希异或四个键得到。
+ * 键表由固定种子生成，同一程序多次运行结果相同。
+ */
+namespace Zobrist
+{
+    /// 支持的最大格子数（10x10棋盘）
+    constexpr int MAX_CELLS = 100;
+
+    /**
+     * @brief 获取格子cell上放置瓦片tile的键
+     */
+    uint64_t key(int cell, int tile);
+
+    /**
+     * @brief 计算完整状态的哈希
+     * @param tiles 状态数组
+     * @param cells 格子数
+     */
+    uint64_t hash(const uint8_t *tiles, int cells);
+
+    /**
+     * @brief 由父状态哈希增量计算空格移动一步后的哈希
+     * @param parentHash 父状态哈希
+     * @param from 空格原位置
+     * @param to 空格新位置
+     * @param tile 被空格交换的瓦片（移动前位于to）
+     * @return 子状态哈希
+     */
+    inline uint64_t moveBlank(uint64_t parentHash, int from, int to, int tile)
+    {
+        return parentHash ^ key(from, 0) ^ key(to, tile) ^ key(from, tile) ^ key(to, 0);
+    }
+}
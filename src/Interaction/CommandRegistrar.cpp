@@ -9,6 +9,8 @@
  * - 空格：播放/暂停（自动播放模式）
  * - 右箭头：下一步（手动模式）
  * - 左箭头：上一步（手动模式）
+ * - H：高亮根节点到当前节点的路径；已标记节点时高亮标记节点到当前节点的路径
+ * - M：标记/取消标记当前节点
  * - R：重置视图
  * - 方向键：步前/步后
  * @copyright Copyright (c) 2025
@@ -19,13 +21,32 @@
 #include "../Visual/DisplayManager.h"
 #include <iostream>
 
+namespace
+{
+    /**
+     * @brief 当前节点：最后显示的节点（没有显示管理器时为最后一个节点）
+     * @return 节点索引，树中没有可用节点时返回-1
+     */
+    int currentNode(const Tree &tree, const DisplayManager *displayManager)
+    {
+        int index = displayManager ? static_cast<int>(displayManager->getVisibleCount()) - 1
+                                   : static_cast<int>(tree.size()) - 1;
+        // DAG视图和流式加载时索引可能有空缺，退回到最近的已建节点
+        while (index >= 0 && !tree.getNodeByIndex(index))
+        {
+            --index;
+        }
+        return index;
+    }
+}
+
 namespace CommandRegistrar
 {
     void registerDefaultCommands(
         InteractionManager &manager,
         CanvasView &canvasView,
         TreeRenderer &treeRenderer,
-        std::shared_ptr<Tree> tree,
+        const std::shared_ptr<Tree> &tree,
         DisplayManager *displayManager)
     {
         static bool showStats = true;
@@ -94,15 +115,45 @@ namespace CommandRegistrar
                           << " mode (" << (state == PlayState::Playing ? "Playing" : "Paused") << ")" << std::endl; }));
         }
 
-        // H: Highlight path
+        // M: Mark/Unmark current node as the other end of highlighted paths
+        auto markedNode = std::make_shared<int>(-1);
+        manager.registerKeyCommand(sf::Keyboard::M,
+                                   std::make_unique<FunctionCommand>([&tree, displayManager, markedNode]()
+                                                                     {
+                int current = tree ? currentNode(*tree, displayManager) : -1;
+                if (current < 0 || *markedNode == current)
+                {
+                    *markedNode = -1;
+                    std::cout << "Clear marked node" << std::endl;
+                }
+                else
+                {
+                    *markedNode = current;
+                    std::cout << "Marked node " << current << std::endl;
+                } }));
+
+        // H: Highlight path from root (or the marked node) to the current node
         manager.registerKeyCommand(sf::Keyboard::H,
-                                   std::make_unique<FunctionCommand>([tree, &treeRenderer]()
+                                   std::make_unique<FunctionCommand>([&tree, &treeRenderer, displayManager, markedNode]()
                                                                      {
-                if (tree && tree->size() > 0)
+                int current = tree ? currentNode(*tree, displayManager) : -1;
+                if (current < 0)
+                {
+                    return;
+                }
+
+                const TreePathIndex &paths = tree->getPathIndex();
+                if (*markedNode >= 0 && paths.contains(*markedNode))
+                {
+                    int ancestor = paths.lca(*markedNode, current);
+                    treeRenderer.setHighlightPath(paths.path(*markedNode, current));
+                    std::cout << "Highlight path: from node " << *markedNode << " to node " << current
+                              << " (LCA " << ancestor << ", distance " << paths.distance(*markedNode, current) << ")" << std::endl;
+                }
+                else
                 {
-                    auto path = tree->getNodeByIndex(tree->size() - 1)->getPathToRoot();
-                    treeRenderer.setHighlightPath(path);
-                    std::cout << "Highlight path: from root to node " << (tree->size() - 1) << std::endl;
+                    treeRenderer.setHighlightPath(paths.pathToRoot(current));
+                    std::cout << "Highlight path: from root to node " << current << std::endl;
                 } }));
 
         // C: Clear highlight
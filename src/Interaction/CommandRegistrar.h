@@ -13,6 +13,6 @@ namespace CommandRegistrar
         InteractionManager &manager,
         CanvasView &canvasView,
         TreeRenderer &treeRenderer,
-        std::shared_ptr<Tree> tree,
+        const std::shared_ptr<Tree> &tree,
         DisplayManager *displayManager = nullptr);
 }
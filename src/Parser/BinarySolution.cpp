@@ -0,0 +1,152 @@
+#include "BinarySolution.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+    template <typename Getter>
+    void writeColumn(std::ofstream &out, uint64_t &offset, size_t count, ColumnSpan<int> span, Getter getter)
+    {
+        // 连续的列直接整块写出，否则逐元素收集
+        std::vector<int32_t> column;
+        if (span.size() != count)
+        {
+            column.resize(count);
+            for (size_t i = 0; i < count; ++i)
+                column[i] = static_cast<int32_t>(getter(static_cast<int>(i)));
+            span = column;
+        }
+        out.write(reinterpret_cast<const char *>(span.data()),
+                  static_cast<std::streamsize>(count * sizeof(int32_t)));
+        offset += count * sizeof(int32_t);
+        writeFilePadding(out, offset);
+    }
+}
+
+BinarySolution::BinarySolution(const std::string &filepath)
+    : file(filepath), boardSize(0), count(0),
+      parents(nullptr), g(nullptr), h(nullptr), f(nullptr), states(nullptr)
+{
+    if (file.size() < sizeof(NpsbHeader))
+        throw std::runtime_error("Binary solution file is truncated: " + filepath);
+
+    NpsbHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, "NPSB", 4) != 0)
+        throw std::runtime_error("Not a binary solution file: " + filepath);
+    if (header.version != NPSB_VERSION)
+        throw std::runtime_error("Unsupported binary solution version: " + std::to_string(header.version));
+    if (header.boardSize < 3 || header.boardSize > 10)
+        throw std::runtime_error("Binary solution format error: state size must be between 3 and 10");
+
+    // 文件头中的数值不可信：先用文件大小约束count再做乘法，范围比较写成减法形式，避免64位回绕绕过检查
+    uint64_t size = file.size();
+    if (header.count > size / sizeof(int32_t))
+        throw std::runtime_error("Binary solution format error: record count exceeds file size");
+    uint64_t columnBytes = header.count * sizeof(int32_t);
+    uint64_t stateBytes = header.count * header.boardSize * header.boardSize;
+    for (uint64_t offset : {header.parentsOffset, header.gOffset, header.hOffset, header.fOffset})
+    {
+        if (offset % alignof(int32_t) != 0 || offset > size || columnBytes > size - offset)
+            throw std::runtime_error("Binary solution format error: column out of range");
+    }
+    if (header.statesOffset > size || stateBytes > size - header.statesOffset)
+        throw std::runtime_error("Binary solution format error: state block out of range");
+
+    boardSize = static_cast<int>(header.boardSize);
+    count = static_cast<size_t>(header.count);
+    parents = reinterpret_cast<const int32_t *>(file.data() + header.parentsOffset);
+    g = reinterpret_cast<const int32_t *>(file.data() + header.gOffset);
+    h = reinterpret_cast<const int32_t *>(file.data() + header.hOffset);
+    f = reinterpret_cast<const int32_t *>(file.data() + header.fOffset);
+    states = reinterpret_cast<const uint8_t *>(file.data() + header.statesOffset);
+}
+
+const PuzzleState &BinarySolution::getState(int index) const
+{
+    int cells = boardSize * boardSize;
+    const uint8_t *tiles = states + static_cast<size_t>(index) * cells;
+    return keepDecoded(PuzzleState(tiles, cells));
+}
+
+std::vector<int> BinarySolution::getPathToRoot(int index) const
+{
+    std::vector<int> path;
+    while (index != -1)
+    {
+        path.push_back(index);
+        index = getParent(index);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+bool isBinarySolutionFile(const std::string &path)
+{
+    std::ifstream fin(path, std::ios::binary);
+    char magic[4] = {};
+    return fin.read(magic, 4) && std::memcmp(magic, "NPSB", 4) == 0;
+}
+
+void writeBinarySolution(const ISolution &solution, const std::string &path)
+{
+    size_t count = solution.size();
+    if (count == 0)
+        throw std::runtime_error("Cannot write empty solution: " + path);
+
+    int cells = solution.getState(0).size();
+    int boardSize = static_cast<int>(std::sqrt(cells));
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        throw std::runtime_error("Cannot open file: " + path);
+
+    NpsbHeader header = {};
+    std::memcpy(header.magic, "NPSB", 4);
+    header.version = NPSB_VERSION;
+    header.boardSize = static_cast<uint32_t>(boardSize);
+    header.count = count;
+
+    uint64_t columnBytes = alignFileOffset(count * sizeof(int32_t));
+    header.parentsOffset = alignFileOffset(sizeof(NpsbHeader));
+    header.gOffset = header.parentsOffset + columnBytes;
+    header.hOffset = header.gOffset + columnBytes;
+    header.fOffset = header.hOffset + columnBytes;
+    header.statesOffset = header.fOffset + columnBytes;
+
+    uint64_t offset = sizeof(NpsbHeader);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writeFilePadding(out, offset);
+
+    writeColumn(out, offset, count, solution.getParentColumn(), [&](int i) { return solution.getParent(i); });
+    writeColumn(out, offset, count, solution.getGColumn(), [&](int i) { return solution.getG(i); });
+    writeColumn(out, offset, count, solution.getHColumn(), [&](int i) { return solution.getH(i); });
+    writeColumn(out, offset, count, solution.getFColumn(), [&](int i) { return solution.getF(i); });
+
+    std::vector<uint8_t> tiles(cells);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const PuzzleState &state = solution.getState(static_cast<int>(i));
+        if (state.size() != cells)
+            throw std::runtime_error("Cannot write binary solution: record " + std::to_string(i) +
+                                     " has a different board size");
+        for (int k = 0; k < cells; ++k)
+            tiles[k] = static_cast<uint8_t>(state[k]);
+        out.write(reinterpret_cast<const char *>(tiles.data()), cells);
+    }
+
+    if (!out)
+        throw std::runtime_error("Failed to write binary solution: " + path);
+}
+
+void convertSolutionToBinary(const std::string &textPath, const std::string &binaryPath)
+{
+    SolutionTree solution(textPath);
+    writeBinarySolution(solution, binaryPath);
+    std::cout << "Converted " << solution.size() << " records from " << textPath
+              << " to " << binaryPath << std::endl;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Solution.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+/**
+ * @brief .npsb 二进制列式解决方案文件头
+ *
+ * 文件布局（小端、按8字节对齐）：
+ * [NpsbHeader][parents int32 x count][g int32 x count][h int32 x count][f int32 x count][states uint8 x count*boardSize^2]
+ */
+struct NpsbHeader
+{
+    char magic[4];         ///< 固定为 "NPSB"
+    uint32_t version;      ///< 格式版本
+    uint32_t boardSize;    ///< 棋盘边长（所有记录相同）
+    uint32_t reserved;     ///< 保留，写0
+    uint64_t count;        ///< 记录数量
+    uint64_t parentsOffset; ///< parents列的文件偏移
+    uint64_t gOffset;      ///< g列的文件偏移
+    uint64_t hOffset;      ///< h列的文件偏移
+    uint64_t fOffset;      ///< f列的文件偏移
+    uint64_t statesOffset; ///< 状态字节区的文件偏移
+};
+
+/// 当前写出的 .npsb 格式版本
+constexpr uint32_t NPSB_VERSION = 1;
+
+static_assert(std::is_same<int32_t, int>::value, "npsb columns are exposed as int columns");
+
+/**
+ * @brief 基于内存映射的二进制解决方案
+ *
+ * 构造时检查文件头和各列范围，各列直接指向映射内存，不向堆复制任何数据；
+ * 语义校验由loadSolutionTree和TreeCache::openSolution在映射的列上完成
+ */
+class BinarySolution : public ISolution {
+private:
+    MappedFile file;               ///< 映射的 .npsb 文件
+    int boardSize;                 ///< 棋盘边长
+    size_t count;                  ///< 记录数量
+    const int32_t *parents;        ///< 父节点索引列
+    const int32_t *g, *h, *f;      ///< g值、h值、f值列
+    const uint8_t *states;         ///< 打包的状态字节
+
+public:
+    /**
+     * @brief 构造函数，映射并校验 .npsb 文件
+     * @param filepath 文件路径
+     * @throws std::runtime_error 文件头无效或文件被截断
+     */
+    BinarySolution(const std::string &filepath);
+
+    ~BinarySolution() {};
+
+    const PuzzleState &getState(int index) const override;
+    int getParent(int index) const override { return parents[index]; }
+    int getG(int index) const override { return g[index]; }
+    int getH(int index) const override { return h[index]; }
+    int getF(int index) const override { return f[index]; }
+    size_t size() const override { return count; }
+
+    std::vector<int> getPathToRoot(int index) const override;
+
+    /**
+     * @brief 映射的文件大小（页可被系统回收，这里按全部驻留计，作为上限）
+     */
+    size_t memoryBytes() const override { return sizeof(*this) + file.size(); }
+
+    // 各列直接指向映射的文件内容
+    ColumnSpan<int> getParentColumn() const override { return {parents, count}; }
+    ColumnSpan<int> getGColumn() const override { return {g, count}; }
+    ColumnSpan<int> getHColumn() const override { return {h, count}; }
+    ColumnSpan<int> getFColumn() const override { return {f, count}; }
+};
+
+/**
+ * @brief 判断文件是否为 .npsb 格式（检查魔数）
+ * @param path 文件路径
+ * @return 是 .npsb 文件返回true
+ */
+bool isBinarySolutionFile(const std::string &path);
+
+/**
+ * @brief 将解决方案写出为 .npsb 文件
+ * @param solution 解决方案数据（所有状态必须具有相同的棋盘大小）
+ * @param path 输出文件路径
+ * @throws std::runtime_error 写入失败或状态大小不一致
+ */
+void writeBinarySolution(const ISolution &solution, const std::string &path);
+
+/**
+ * @brief 将文本格式的 solution.txt 转换为 .npsb
+ * @param textPath 文本解决方案路径
+ * @param binaryPath 输出 .npsb 路径
+ */
+void convertSolutionToBinary(const std::string &textPath, const std::string &binaryPath);
@@ -0,0 +1,202 @@
+#include "DeltaSolution.h"
+#include "MappedFile.h"
+#include "SolutionScanner.h"
+#include "SolutionValidator.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    int findBlank(const PuzzleState &state)
+    {
+        const uint8_t *tiles = state.data();
+        const uint8_t *blank = std::find(tiles, tiles + state.size(), 0);
+        return blank == tiles + state.size() ? -1 : static_cast<int>(blank - tiles);
+    }
+
+    // 空格从from移动到to对应的移动编码，不是相邻格返回-1
+    int moveCode(int from, int to, int n)
+    {
+        if (to == from - n)
+            return 0; // UP
+        if (to == from + n)
+            return 1; // DOWN
+        if (to == from - 1 && from % n != 0)
+            return 2; // LEFT
+        if (to == from + 1 && to % n != 0)
+            return 3; // RIGHT
+        return -1;
+    }
+}
+
+DeltaSolution::DeltaSolution(const std::string &filepath)
+    : boardSize(0)
+{
+    MappedFile file(filepath);
+    size_t expected = SolutionScanner::countRecords(file.begin(), file.end());
+    parents.reserve(expected);
+    g.reserve(expected);
+    h.reserve(expected);
+    f.reserve(expected);
+    moves.reserve(expected);
+
+    std::vector<uint8_t> hops;
+    hops.reserve(expected);
+
+    SolutionRecord record;
+    const char *p = file.begin();
+    while (SolutionScanner::readRecord(p, file.end(), record, parents.size()))
+    {
+        if (boardSize == 0)
+            boardSize = record.size;
+        else if (record.size != boardSize)
+            throw std::runtime_error("Solution file format error: record " + std::to_string(parents.size()) +
+                                     " has a different board size");
+
+        g.push_back(record.g);
+        h.push_back(record.h);
+        f.push_back(record.f);
+        append(record.parent, PuzzleState(record.tiles), hops);
+    }
+
+    // 父节点在后面的记录（极少见）解析完后才能检查
+    int count = static_cast<int>(parents.size());
+    for (int i = 0; i < count; ++i)
+    {
+        if (parents[i] <= i)
+            continue;
+        if (parents[i] >= count)
+            throw std::runtime_error("Solution validation error: record " + std::to_string(i) + " has an invalid parent");
+        PuzzleState state = decodeState(i);
+        PuzzleState parentState = decodeState(parents[i]);
+        if (!SolutionValidator::isSingleMove(parentState.data(), state.data(), boardSize))
+            throw std::runtime_error("Solution validation error: record " + std::to_string(i) +
+                                     " is not one legal blank move from its parent");
+    }
+}
+
+void DeltaSolution::append(int parent, const PuzzleState &state, std::vector<uint8_t> &hops)
+{
+    // 解码时逐条做结构校验，打开后不再整体回放一遍状态
+    int index = static_cast<int>(parents.size());
+    if (!SolutionValidator::isPermutation(state.data(), static_cast<int>(state.size())))
+        throw std::runtime_error("Solution validation error: record " + std::to_string(index) + " is not a permutation");
+    if (parent < -1 || parent == index)
+        throw std::runtime_error("Solution validation error: record " + std::to_string(index) + " has an invalid parent");
+    parents.push_back(parent);
+
+    // 父节点已出现时必须恰好差一次空格移动，未到检查点间隔时只记录这一步移动
+    int code = -1;
+    if (parent >= 0 && parent < index)
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        const PuzzleState &parentState = lookup(parent);
+        if (!SolutionValidator::isSingleMove(parentState.data(), state.data(), boardSize))
+            throw std::runtime_error("Solution validation error: record " + std::to_string(index) +
+                                     " is not one legal blank move from its parent");
+        if (hops[parent] + 1 < CHECKPOINT_INTERVAL)
+            code = moveCode(findBlank(parentState), findBlank(state), boardSize);
+    }
+
+    if (code >= 0)
+    {
+        moves.push_back(static_cast<uint8_t>(code));
+        hops.push_back(static_cast<uint8_t>(hops[parent] + 1));
+    }
+    else
+    {
+        moves.push_back(CHECKPOINT);
+        hops.push_back(0);
+        checkpointNodes.push_back(index);
+        checkpointTiles.insert(checkpointTiles.end(), state.data(), state.data() + state.size());
+    }
+}
+
+PuzzleState DeltaSolution::rebuild(int index) const
+{
+    // 沿父节点链向上收集移动，直到遇到检查点
+    uint8_t path[CHECKPOINT_INTERVAL];
+    int length = 0;
+    int node = index;
+    while (moves[node] != CHECKPOINT)
+    {
+        path[length++] = moves[node];
+        node = parents[node];
+    }
+
+    int cells = boardSize * boardSize;
+    size_t slot = std::lower_bound(checkpointNodes.begin(), checkpointNodes.end(), node) - checkpointNodes.begin();
+    PuzzleState state(checkpointTiles.data() + slot * cells, cells);
+
+    // 从检查点向下回放移动
+    int blank = findBlank(state);
+    const int offsets[4] = {-boardSize, boardSize, -1, 1};
+    for (int i = length - 1; i >= 0; --i)
+    {
+        int target = blank + offsets[path[i]];
+        state.setValue(blank, state[target]);
+        state.setValue(target, 0);
+        blank = target;
+    }
+    return state;
+}
+
+const PuzzleState &DeltaSolution::lookup(int index) const
+{
+    auto it = cacheIndex.find(index);
+    if (it != cacheIndex.end())
+    {
+        cacheEntries.splice(cacheEntries.begin(), cacheEntries, it->second);
+        return it->second->second;
+    }
+
+    cacheEntries.emplace_front(index, rebuild(index));
+    cacheIndex[index] = cacheEntries.begin();
+    if (cacheEntries.size() > CACHE_CAPACITY)
+    {
+        cacheIndex.erase(cacheEntries.back().first);
+        cacheEntries.pop_back();
+    }
+    return cacheEntries.front().second;
+}
+
+const PuzzleState &DeltaSolution::getState(int index) const
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return keepDecoded(lookup(index));
+}
+
+PuzzleState DeltaSolution::decodeState(int index) const
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return lookup(index);
+}
+
+size_t DeltaSolution::memoryBytes() const
+{
+    size_t bytes = sizeof(*this) + vectorBytes(parents) + vectorBytes(g) + vectorBytes(h) + vectorBytes(f) +
+                   vectorBytes(moves) + vectorBytes(checkpointNodes) + vectorBytes(checkpointTiles);
+
+    // LRU缓存：链表节点（两个指针加元素）和哈希表节点（一个指针加键值）
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    bytes += cacheEntries.size() * (2 * sizeof(void *) + sizeof(std::pair<int, PuzzleState>));
+    bytes += cacheIndex.size() * (2 * sizeof(void *) + sizeof(int)) + cacheIndex.bucket_count() * sizeof(void *);
+    return bytes;
+}
+
+std::vector<int> DeltaSolution::getPathToRoot(int index) const
+{
+    std::vector<int> path;
+    while (index != -1)
+    {
+        path.push_back(index);
+        index = getParent(index);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::unique_ptr<ISolution> loadSolutionTreeDelta(const std::string &path)
+{
+    return std::make_unique<DeltaSolution>(path);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Solution.h"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 差分编码的树形解决方案
+ *
+ * 搜索树中子节点与父节点只差一次空格移动，因此每个节点只存一个移动编码，
+ * 沿父节点链每隔CHECKPOINT_INTERVAL层保存一个完整状态作为检查点。
+ * decodeState从最近的祖先检查点回放移动重建状态，最近重建的状态保存在一个小的LRU缓存中；
+ * getState把结果放入线程内的环形缓冲区返回引用。
+ * 根节点和父节点在后面的记录直接保存为检查点。
+ * 结构校验在解码时逐条完成（排列、父节点存在、一步合法移动），打开后无需再整体校验。
+ */
+class DeltaSolution : public ISolution {
+private:
+    /// 沿父节点链相邻两个检查点之间的最大层数
+    static constexpr int CHECKPOINT_INTERVAL = 16;
+
+    /// LRU缓存容量
+    static constexpr size_t CACHE_CAPACITY = 1024;
+
+    /// 移动编码：空格移动方向，CHECKPOINT表示该节点保存了完整状态
+    enum Move : uint8_t { MOVE_UP = 0, MOVE_DOWN = 1, MOVE_LEFT = 2, MOVE_RIGHT = 3, CHECKPOINT = 0xFF };
+
+    int boardSize;                        ///< 棋盘边长
+    std::vector<int> parents;             ///< 父节点索引列
+    std::vector<int> g, h, f;             ///< g值、h值、f值列
+    std::vector<uint8_t> moves;           ///< 每个节点相对父节点的空格移动
+    std::vector<int> checkpointNodes;     ///< 检查点节点索引（递增）
+    std::vector<uint8_t> checkpointTiles; ///< 检查点状态，每个boardSize*boardSize字节
+
+    mutable std::mutex cacheMutex;                                                  ///< 保护LRU缓存
+    mutable std::list<std::pair<int, PuzzleState>> cacheEntries;                   ///< 最近使用的在前
+    mutable std::unordered_map<int, std::list<std::pair<int, PuzzleState>>::iterator> cacheIndex;
+
+    /**
+     * @brief 追加一条记录
+     * @param parent 父节点索引
+     * @param state 状态
+     * @param hops 每个节点距最近检查点的层数（构建期间使用）
+     */
+    void append(int parent, const PuzzleState &state, std::vector<uint8_t> &hops);
+
+    /**
+     * @brief 重建指定节点的状态（不加锁）
+     */
+    PuzzleState rebuild(int index) const;
+
+    /**
+     * @brief 在缓存中查找或重建状态（调用方须持有cacheMutex）
+     */
+    const PuzzleState &lookup(int index) const;
+
+public:
+    /**
+     * @brief 构造函数，逐条解析solution.txt并差分编码，不在内存中保留完整状态列
+     * @param filepath 解决方案文件路径
+     * @throws std::runtime_error 文件无法打开、格式错误或结构校验失败
+     */
+    DeltaSolution(const std::string &filepath);
+
+    ~DeltaSolution() {};
+
+    const PuzzleState &getState(int index) const override;
+    PuzzleState decodeState(int index) const override;
+    int getParent(int index) const override { return parents[index]; }
+    int getG(int index) const override { return g[index]; }
+    int getH(int index) const override { return h[index]; }
+    int getF(int index) const override { return f[index]; }
+    size_t size() const override { return parents.size(); }
+
+    std::vector<int> getPathToRoot(int index) const override;
+    size_t memoryBytes() const override;
+
+    ColumnSpan<int> getParentColumn() const override { return parents; }
+    ColumnSpan<int> getGColumn() const override { return g; }
+    ColumnSpan<int> getHColumn() const override { return h; }
+    ColumnSpan<int> getFColumn() const override { return f; }
+
+    /**
+     * @brief 获取状态存储占用的字节数（移动编码与检查点）
+     */
+    size_t stateBytes() const { return moves.size() + checkpointTiles.size() + checkpointNodes.size() * sizeof(int); }
+};
+
+/**
+ * @brief 以差分编码方式加载树形解决方案
+ * @param path 解决方案文件路径
+ * @return 指向ISolution的智能指针
+ */
+std::unique_ptr<ISolution> loadSolutionTreeDelta(const std::string &path);
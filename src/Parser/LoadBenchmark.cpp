@@ -0,0 +1,102 @@
+#include "LoadBenchmark.h"
+#include "Solution.h"
+#include "MappedFile.h"
+#include "SolutionScanner.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * @brief 原来的加载方式：ifstream逐个读取整数，各列边读边增长
+     */
+    void parseWithStream(const std::string &path, SolutionColumns &columns)
+    {
+        std::ifstream fin(path);
+        if (!fin.is_open())
+            throw std::runtime_error("Cannot open file: " + path);
+        int size;
+        while (fin >> size)
+        {
+            if (size < 3 || size > 10)
+                throw std::runtime_error("Solution file format error: state size must be between 3 and 10");
+            int p_, g_, h_, f_;
+            fin >> p_ >> g_ >> h_ >> f_;
+            columns.parents.push_back(p_);
+            columns.g.push_back(g_);
+            columns.h.push_back(h_);
+            columns.f.push_back(f_);
+            std::vector<int> state(size * size, 0);
+            for (int i = 0; i < size * size; ++i)
+                fin >> state[i];
+            columns.states.push_back(PuzzleState(state));
+        }
+    }
+
+    bool sameColumns(const SolutionColumns &a, const SolutionColumns &b)
+    {
+        return a.parents == b.parents && a.g == b.g && a.h == b.h && a.f == b.f && a.states == b.states;
+    }
+
+    /**
+     * @brief 重复执行repeat次，返回最快一次的毫秒数
+     */
+    double bestOf(unsigned repeat, const std::function<void()> &run)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (unsigned i = 0; i < repeat; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+}
+
+void runLoadBenchmark(const std::string &path, unsigned repeat)
+{
+    repeat = std::max(1u, repeat);
+    double megabytes = MappedFile(path).size() / (1024.0 * 1024.0);
+
+    SolutionColumns streamColumns, serialColumns, parallelColumns;
+    double streamMs = bestOf(repeat, [&]
+                             { streamColumns = SolutionColumns(); parseWithStream(path, streamColumns); });
+    double serialMs = bestOf(repeat, [&]
+                             {
+                                 MappedFile file(path);
+                                 serialColumns = SolutionColumns();
+                                 serialColumns.reserve(SolutionScanner::countRecords(file.begin(), file.end()));
+                                 SolutionScanner::parseRecords(file.begin(), file.end(), serialColumns); });
+    double parallelMs = bestOf(repeat, [&]
+                               {
+                                   MappedFile file(path);
+                                   parallelColumns = SolutionColumns();
+                                   SolutionScanner::parseRecordsParallel(file.begin(), file.end(), parallelColumns); });
+    double loadMs = bestOf(repeat, [&]
+                           { loadSolutionTree(path); });
+
+    if (!sameColumns(streamColumns, serialColumns) || !sameColumns(streamColumns, parallelColumns))
+        throw std::runtime_error("Load benchmark: parsers disagree on " + path);
+
+    std::cout << path << ": " << streamColumns.size() << " records, " << std::fixed << std::setprecision(1)
+              << megabytes << " MB, best of " << repeat << std::endl;
+    std::cout << std::left << std::setw(24) << "method" << std::right << std::setw(12) << "ms"
+              << std::setw(10) << "MB/s" << std::setw(10) << "speedup" << std::endl;
+    auto report = [&](const char *method, double milliseconds)
+    {
+        std::cout << std::left << std::setw(24) << method << std::right << std::setw(12) << milliseconds
+                  << std::setw(10) << megabytes * 1000.0 / milliseconds
+                  << std::setw(9) << streamMs / milliseconds << "x" << std::endl;
+    };
+    report("ifstream (old)", streamMs);
+    report("mmap + from_chars", serialMs);
+    report("mmap + parallel chunks", parallelMs);
+    report("loadSolutionTree", loadMs);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+
+/**
+ * @brief 解决方案加载基准测试
+ *
+ * 对同一个solution.txt依次用原来的iostream逐个读取、内存映射+from_chars串行扫描、
+ * 多线程分块扫描三种方式解析，再完整走一遍loadSolutionTree（含语义校验），
+ * 每种方式重复若干次取最快一次，输出耗时、吞吐量和相对iostream的加速比，并确认三种解析得到的列完全一致。
+ * 命令行用法：--bench-load solution.txt [repeat]
+ * @param path 文本解决方案路径
+ * @param repeat 每种方式的重复次数
+ */
+void runLoadBenchmark(const std::string &path, unsigned repeat);
@@ -0,0 +1,115 @@
+#include "MappedFile.h"
+#include <ostream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string &filepath)
+    : m_data(nullptr), m_size(0), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+{
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Cannot open file: " + filepath);
+    m_file = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Cannot stat file: " + filepath);
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+
+    // 空文件无法映射，直接返回空视图
+    if (m_size == 0)
+        return;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Cannot map file: " + filepath);
+    }
+    m_mapping = mapping;
+
+    m_data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Cannot map file: " + filepath);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(static_cast<HANDLE>(m_mapping));
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(static_cast<HANDLE>(m_file));
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &filepath)
+    : m_data(nullptr), m_size(0), m_fd(-1)
+{
+    m_fd = ::open(filepath.c_str(), O_RDONLY);
+    if (m_fd < 0)
+        throw std::runtime_error("Cannot open file: " + filepath);
+
+    struct stat st;
+    if (::fstat(m_fd, &st) != 0)
+    {
+        ::close(m_fd);
+        throw std::runtime_error("Cannot stat file: " + filepath);
+    }
+    m_size = static_cast<size_t>(st.st_size);
+
+    // 空文件无法映射，直接返回空视图
+    if (m_size == 0)
+        return;
+
+    void *addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (addr == MAP_FAILED)
+    {
+        ::close(m_fd);
+        throw std::runtime_error("Cannot map file: " + filepath);
+    }
+    // 解析器按顺序扫描整个文件
+    ::madvise(addr, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const char *>(addr);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+        ::munmap(const_cast<char *>(m_data), m_size);
+    if (m_fd >= 0)
+        ::close(m_fd);
+}
+
+#endif
+
+void writeFilePadding(std::ostream &out, uint64_t &offset)
+{
+    static const char zeros[8] = {};
+    uint64_t aligned = alignFileOffset(offset);
+    out.write(zeros, static_cast<std::streamsize>(aligned - offset));
+    offset = aligned;
+}
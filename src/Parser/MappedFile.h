@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+/**
+ * @brief 只读内存映射文件
+ *
+ * 将整个文件映射到进程地址空间，供解析器直接按字节扫描，避免逐个读取带来的拷贝和流开销。
+ * Windows 下使用 CreateFileMapping/MapViewOfFile，其他平台使用 mmap。
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief 构造函数，打开并映射文件
+     * @param filepath 文件路径
+     * @throws std::runtime_error 文件无法打开或映射失败
+     */
+    explicit MappedFile(const std::string &filepath);
+
+    /**
+     * @brief 析构函数，解除映射并关闭文件
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief 获取映射数据起始地址（空文件返回nullptr）
+     */
+    const char *data() const { return m_data; }
+
+    /**
+     * @brief 获取文件字节数
+     */
+    size_t size() const { return m_size; }
+
+    const char *begin() const { return m_data; }
+    const char *end() const { return m_data + m_size; }
+
+private:
+    const char *m_data; // 映射起始地址
+    size_t m_size;      // 映射字节数
+
+#ifdef _WIN32
+    void *m_file;    // 文件句柄
+    void *m_mapping; // 映射句柄
+#else
+    int m_fd; // 文件描述符
+#endif
+};
+
+/**
+ * @brief 把文件偏移向上对齐到8字节
+ *
+ * 映射的二进制文件（.npsb、.nplc）中各列按8字节对齐写出，保证映射后按列类型访问时地址对齐
+ */
+inline uint64_t alignFileOffset(uint64_t offset)
+{
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+/**
+ * @brief 写入0字节直到偏移对齐到8字节
+ * @param out 输出流
+ * @param offset 当前写入偏移，返回时为对齐后的偏移
+ */
+void writeFilePadding(std::ostream &out, uint64_t &offset);
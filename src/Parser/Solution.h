@@ -1,9 +1,35 @@
 #pragma once
 
 #include "../Core/PuzzleState.h"
+#include "SolutionScanner.h"
 #include <vector>
 #include <string>
 #include <memory>
+#include <cstddef>
+
+/**
+ * @brief 连续内存列的只读视图（指针+长度，C++17下std::span的最小替代）
+ *
+ * 不持有数据，生命周期由提供它的解决方案保证
+ */
+template <typename T>
+class ColumnSpan {
+private:
+    const T *ptr = nullptr; ///< 首元素
+    size_t count = 0;       ///< 元素个数
+
+public:
+    ColumnSpan() = default;
+    ColumnSpan(const T *data, size_t size) : ptr(data), count(size) {}
+    ColumnSpan(const std::vector<T> &values) : ptr(values.data()), count(values.size()) {}
+
+    const T *data() const { return ptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T &operator[](size_t index) const { return ptr[index]; }
+    const T *begin() const { return ptr; }
+    const T *end() const { return ptr + count; }
+};
 
 /**
  * @brief 解决方案接口基类
@@ -16,10 +42,23 @@ public:
     
     /**
      * @brief 获取指定索引的状态
+     *
+     * 保存了完整状态对象的实现（SolutionTree、SolutionAnimation）返回列中元素的引用，不复制。
+     * 按需解码的实现（映射文件、增量编码、流式加载）把解码结果放入当前线程的小环形缓冲区，
+     * 返回的引用在当前线程随后DECODED_STATE_SLOTS次解码之前有效；需要长期持有时使用decodeState
      * @param index 状态索引
      * @return 对应的拼图状态
      */
     virtual const PuzzleState &getState(int index) const = 0;
+
+    /**
+     * @brief 按值获取指定索引的状态
+     *
+     * 默认复制getState的结果；DeltaSolution和StreamingSolution直接解码返回，不经过环形缓冲区
+     * @param index 状态索引
+     * @return 对应的拼图状态
+     */
+    virtual PuzzleState decodeState(int index) const { return getState(index); }
     
     /**
      * @brief 获取指定索引的父节点索引
@@ -54,6 +93,23 @@ public:
      * @return 状态数量
      */
     virtual size_t size() const = 0;
+
+    /**
+     * @brief 数据是否已全部加载
+     *
+     * 流式加载的实现在后台填充数据期间返回false，此时size()会持续增长
+     * @return 已全部加载返回true
+     */
+    virtual bool isComplete() const { return true; }
+
+    /**
+     * @brief 加载是否因错误提前结束
+     *
+     * 流式加载遇到截断或损坏的记录时停止，此时isComplete()同样返回true，
+     * 但只有出错之前的记录可用，调用方不应持久化或长期缓存这样的数据
+     * @return 加载出错返回true
+     */
+    virtual bool hasFailed() const { return false; }
     
     /**
      * @brief 获取从指定节点到根节点的路径
@@ -61,6 +117,69 @@ public:
      * @return 路径索引列表，从根节点到指定节点
      */
     virtual std::vector<int> getPathToRoot(int index) const = 0;
+
+    /**
+     * @brief 批量访问：父节点索引列
+     *
+     * 数据连续存放的实现返回整列视图，调用方可以直接扫描而不必每个元素一次虚调用。
+     * 数据不连续（如分块的流式加载）时返回空视图，调用方应退回逐元素访问。
+     * 以下各列同理，只有长度等于size()的视图才可用。
+     * @return 父节点索引列视图
+     */
+    virtual ColumnSpan<int> getParentColumn() const { return {}; }
+
+    /**
+     * @brief 批量访问：g值列
+     */
+    virtual ColumnSpan<int> getGColumn() const { return {}; }
+
+    /**
+     * @brief 批量访问：h值列
+     */
+    virtual ColumnSpan<int> getHColumn() const { return {}; }
+
+    /**
+     * @brief 批量访问：f值列
+     */
+    virtual ColumnSpan<int> getFColumn() const { return {}; }
+
+    /**
+     * @brief 批量访问：状态列（只有完整保存状态对象的实现提供）
+     */
+    virtual ColumnSpan<PuzzleState> getStateColumn() const { return {}; }
+
+    /**
+     * @brief 占用的内存字节数
+     *
+     * 各实现按自己的存储方式统计（完整状态列、差分编码、映射的文件等），供会话缓存按预算淘汰
+     * @return 字节数
+     */
+    virtual size_t memoryBytes() const = 0;
+
+protected:
+    /// 每个线程为getState保留的解码状态数
+    static constexpr int DECODED_STATE_SLOTS = 16;
+
+    /**
+     * @brief 把解码出的状态放入当前线程的环形缓冲区，返回其引用
+     *
+     * 供按需解码的实现实现getState；缓冲区按线程独立，多个线程同时访问不需要加锁
+     */
+    static const PuzzleState &keepDecoded(const PuzzleState &state)
+    {
+        thread_local PuzzleState slots[DECODED_STATE_SLOTS];
+        thread_local int next = 0;
+        PuzzleState &slot = slots[next];
+        next = (next + 1) % DECODED_STATE_SLOTS;
+        slot = state;
+        return slot;
+    }
+
+    /**
+     * @brief vector已分配的字节数（按容量计）
+     */
+    template <typename T>
+    static size_t vectorBytes(const std::vector<T> &values) { return values.capacity() * sizeof(T); }
 };
 
 /**
@@ -70,27 +189,35 @@ public:
  */
 class SolutionTree : public ISolution {
 private:
-    std::vector<PuzzleState> states;    ///< 所有状态集合
-    std::vector<int> parents;           ///< 父节点索引集合
-    std::vector<int> g, h, f;           ///< g值、h值、f值集合
+    SolutionColumns columns;            ///< 状态、父节点索引、g/h/f值列
 
 public:
     /**
      * @brief 构造函数，从文件加载树形解决方案数据
+     *
+     * 文件被内存映射后一次性扫描，先按行数预分配各列再逐条解析
      * @param filepath 解决方案文件路径
      */
     SolutionTree(const std::string &filepath);
     
     ~SolutionTree() {};
 
-    const PuzzleState &getState(int index) const override { return states[index]; }
-    int getParent(int index) const override { return parents[index]; }
-    int getG(int index) const override { return g[index]; }
-    int getH(int index) const override { return h[index]; }
-    int getF(int index) const override { return f[index]; }
-    size_t size() const override { return states.size(); }
+    const PuzzleState &getState(int index) const override { return columns.states[index]; }
+    int getParent(int index) const override { return columns.parents[index]; }
+    int getG(int index) const override { return columns.g[index]; }
+    int getH(int index) const override { return columns.h[index]; }
+    int getF(int index) const override { return columns.f[index]; }
+    size_t size() const override { return columns.size(); }
 
     std::vector<int> getPathToRoot(int index) const override;
+
+    ColumnSpan<int> getParentColumn() const override { return columns.parents; }
+    ColumnSpan<int> getGColumn() const override { return columns.g; }
+    ColumnSpan<int> getHColumn() const override { return columns.h; }
+    ColumnSpan<int> getFColumn() const override { return columns.f; }
+    ColumnSpan<PuzzleState> getStateColumn() const override { return columns.states; }
+
+    size_t memoryBytes() const override;
 };
 
 /**
@@ -102,6 +229,9 @@ class SolutionAnimation : public ISolution {
 private:
     std::vector<PuzzleState> states;    ///< 状态序列
     std::vector<std::string> actions;   ///< 动作序列
+    std::vector<int> parents;           ///< 父节点索引列（index-1），供批量访问
+    std::vector<int> steps;             ///< 步数列（g值和f值），供批量访问
+    std::vector<int> zeros;             ///< 全0列（h值），供批量访问
 
 public:
     /**
@@ -152,10 +282,20 @@ public:
      * @return 动作字符串（UP/DOWN/LEFT/RIGHT）
      */
     const std::string &getAction(int index) const { return actions[index]; }
+
+    ColumnSpan<int> getParentColumn() const override { return parents; }
+    ColumnSpan<int> getGColumn() const override { return steps; }
+    ColumnSpan<int> getHColumn() const override { return zeros; }
+    ColumnSpan<int> getFColumn() const override { return steps; }
+    ColumnSpan<PuzzleState> getStateColumn() const override { return states; }
+
+    size_t memoryBytes() const override;
 };
 
 /**
  * @brief 加载树形解决方案
+ *
+ * 根据文件魔数自动选择 .npsb 二进制格式或文本格式
  * @param path 解决方案文件路径
  * @return 指向ISolution的智能指针
  */
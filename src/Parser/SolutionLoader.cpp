@@ -1,8 +1,14 @@
 #include "Solution.h"
+#include "MappedFile.h"
+#include "BinarySolution.h"
+#include "DeltaSolution.h"
+#include "SolutionValidator.h"
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <iostream>
+#include <chrono>
 
 // Helper function to apply an action to a puzzle state
 std::vector<int> applyAction(const std::vector<int>& state, const std::string& action, int size)
@@ -60,27 +66,13 @@ std::vector<int> applyAction(const std::vector<int>& state, const std::string& a
 // SolutionTree implementation for structured tree data
 SolutionTree::SolutionTree(const std::string &filepath)
 {
-    std::ifstream fin(filepath);
-    if (!fin.is_open())
-        throw std::runtime_error("Cannot open file: " + filepath);
-    int size;
-    while (fin >> size)
-    {
-        if (size < 3 || size > 10)
-            throw std::runtime_error("Solution file format error: state size must be between 3 and 10");
-        int p_, g_, h_, f_;
-        fin >> p_ >> g_ >> h_ >> f_;
-        parents.push_back(p_);
-        g.push_back(g_);
-        h.push_back(h_);
-        f.push_back(f_);
-        std::vector<int> state(size * size, 0);
-        for (int i = 0; i < size * size; ++i)
-            fin >> state[i];
-        states.push_back(PuzzleState(state));
-    }
-    if (parents.size() != states.size())
-        throw std::runtime_error("Solution file format error: number of parents does not match number of states");
+    MappedFile file(filepath);
+
+    // 大文件按行切块多线程解析，小文件先数行数预分配各列后串行解析
+    SolutionScanner::parseRecordsParallel(file.begin(), file.end(), columns);
+
+    // 解析只检查格式，语义错误（非排列、父节点缺失、非法移动）在这里拦下，避免之后在TreeBuilder中崩溃
+    SolutionValidator::requireValid(SolutionValidator::validate(columns), filepath);
 }
 
 std::vector<int> SolutionTree::getPathToRoot(int index) const
@@ -95,6 +87,12 @@ std::vector<int> SolutionTree::getPathToRoot(int index) const
     return path;
 }
 
+size_t SolutionTree::memoryBytes() const
+{
+    return sizeof(*this) + vectorBytes(columns.states) + vectorBytes(columns.parents) +
+           vectorBytes(columns.g) + vectorBytes(columns.h) + vectorBytes(columns.f);
+}
+
 // SolutionAnimation implementation for action-based animation data
 SolutionAnimation::SolutionAnimation(const std::string &filepath)
 {
@@ -140,6 +138,16 @@ SolutionAnimation::SolutionAnimation(const std::string &filepath)
         currentState = applyAction(currentState, actions[i], size);
         states.push_back(PuzzleState(currentState));
     }
+
+    // 父节点、g/h/f由步数决定，物化成列以便批量访问
+    parents.resize(states.size());
+    steps.resize(states.size());
+    zeros.assign(states.size(), 0);
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+        parents[i] = static_cast<int>(i) - 1;
+        steps[i] = static_cast<int>(i);
+    }
 }
 
 std::vector<int> SolutionAnimation::getPathToRoot(int index) const
@@ -154,10 +162,37 @@ std::vector<int> SolutionAnimation::getPathToRoot(int index) const
     return path;
 }
 
+size_t SolutionAnimation::memoryBytes() const
+{
+    // 动作字符串（UP/DOWN/LEFT/RIGHT）很短，内联在string对象中
+    return sizeof(*this) + vectorBytes(states) + vectorBytes(actions) +
+           vectorBytes(parents) + vectorBytes(steps) + vectorBytes(zeros);
+}
+
 // Factory functions
+// 文本解决方案超过该大小时改用差分编码存储状态
+static constexpr uintmax_t DELTA_ENCODING_THRESHOLD = 256ull * 1024 * 1024;
+
 std::unique_ptr<ISolution> loadSolutionTree(const std::string &path)
 {
-    return std::make_unique<SolutionTree>(path);
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<ISolution> solution;
+    std::error_code ec;
+    uintmax_t fileSize = std::filesystem::file_size(path, ec);
+    if (isBinarySolutionFile(path))
+    {
+        // .npsb可能是手写、损坏或被替换的文件，每次打开都在映射的列上做一遍语义校验
+        solution = std::make_unique<BinarySolution>(path);
+        SolutionValidator::requireValid(SolutionValidator::validate(*solution), path);
+    }
+    else if (!ec && fileSize >= DELTA_ENCODING_THRESHOLD)
+        solution = std::make_unique<DeltaSolution>(path); // 超大文本轨迹差分编码存储状态，解码时逐条校验
+    else
+        solution = std::make_unique<SolutionTree>(path); // 构造时已直接在列上校验
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Loaded " << solution->size() << " records from " << path
+              << " in " << elapsed.count() << " ms" << std::endl;
+    return solution;
 }
 
 std::unique_ptr<ISolution> loadSolutionAnimation(const std::string &path)
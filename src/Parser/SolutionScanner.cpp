@@ -0,0 +1,196 @@
+#include "SolutionScanner.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+void SolutionColumns::reserve(size_t count)
+{
+    states.reserve(count);
+    parents.reserve(count);
+    g.reserve(count);
+    h.reserve(count);
+    f.reserve(count);
+}
+
+namespace
+{
+    // 小于该字节数的输入串行解析即可，线程启动开销不值得
+    constexpr size_t PARALLEL_PARSE_MIN_BYTES = 8 * 1024 * 1024;
+
+    template <typename T>
+    void appendColumn(std::vector<T> &dst, std::vector<T> &src)
+    {
+        dst.insert(dst.end(), std::make_move_iterator(src.begin()), std::make_move_iterator(src.end()));
+        std::vector<T>().swap(src);
+    }
+
+    inline bool isSpace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    inline const char *skipSpaces(const char *p, const char *end)
+    {
+        while (p < end && isSpace(*p))
+            ++p;
+        return p;
+    }
+
+    // 读取下一个整数，失败时抛出异常（recordIndex用于错误信息）
+    inline const char *readInt(const char *p, const char *end, int &value, size_t recordIndex)
+    {
+        p = skipSpaces(p, end);
+        auto result = std::from_chars(p, end, value);
+        if (result.ec != std::errc())
+        {
+            throw std::runtime_error("Solution file format error: invalid or truncated record " +
+                                     std::to_string(recordIndex));
+        }
+        return result.ptr;
+    }
+}
+
+namespace SolutionScanner
+{
+    size_t countRecords(const char *begin, const char *end)
+    {
+        if (begin == end)
+            return 0;
+        size_t lines = static_cast<size_t>(std::count(begin, end, '\n'));
+        if (end[-1] != '\n')
+            ++lines;
+        return lines;
+    }
+
+    bool readRecord(const char *&p, const char *end, SolutionRecord &record, size_t recordIndex)
+    {
+        p = skipSpaces(p, end);
+        if (p >= end)
+            return false;
+
+        p = readInt(p, end, record.size, recordIndex);
+        if (record.size < 3 || record.size > 10)
+            throw std::runtime_error("Solution file format error: state size must be between 3 and 10");
+
+        p = readInt(p, end, record.parent, recordIndex);
+        p = readInt(p, end, record.g, recordIndex);
+        p = readInt(p, end, record.h, recordIndex);
+        p = readInt(p, end, record.f, recordIndex);
+
+        int cells = record.size * record.size;
+        record.tiles.resize(cells);
+        for (int i = 0; i < cells; ++i)
+        {
+            p = readInt(p, end, record.tiles[i], recordIndex);
+            if (record.tiles[i] < 0 || record.tiles[i] > 255)
+                throw std::runtime_error("Solution file format error: tile value out of range in record " +
+                                         std::to_string(recordIndex));
+        }
+        return true;
+    }
+
+    void parseRecords(const char *begin, const char *end, SolutionColumns &columns, size_t firstRecord)
+    {
+        SolutionRecord record;
+        const char *p = begin;
+        while (readRecord(p, end, record, firstRecord++))
+        {
+            columns.parents.push_back(record.parent);
+            columns.g.push_back(record.g);
+            columns.h.push_back(record.h);
+            columns.f.push_back(record.f);
+            columns.states.emplace_back(record.tiles);
+        }
+    }
+
+    void parseRecordsParallel(const char *begin, const char *end, SolutionColumns &columns, unsigned threadCount)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        size_t bytes = static_cast<size_t>(end - begin);
+        if (threadCount == 1 || bytes < PARALLEL_PARSE_MIN_BYTES)
+        {
+            columns.reserve(columns.size() + countRecords(begin, end));
+            parseRecords(begin, end, columns, columns.size());
+            return;
+        }
+
+        // 按字节均分后把每个切分点推进到下一个换行符之后，保证每块都由完整的行组成
+        std::vector<const char *> bounds{begin};
+        for (unsigned i = 1; i < threadCount; ++i)
+        {
+            const char *cut = std::max(bounds.back(), begin + bytes * i / threadCount);
+            const char *newline = static_cast<const char *>(std::memchr(cut, '\n', end - cut));
+            const char *next = newline ? newline + 1 : end;
+            if (next > bounds.back() && next < end)
+                bounds.push_back(next);
+        }
+        bounds.push_back(end);
+        size_t chunkCount = bounds.size() - 1;
+
+        std::vector<SolutionColumns> chunks(chunkCount);
+        std::vector<size_t> firstRecord(chunkCount + 1, columns.size());
+        std::vector<std::exception_ptr> errors(chunkCount);
+
+        // 第一遍：并行数行，确定每块的记录起始编号并预分配块缓冲
+        std::vector<size_t> lineCounts(chunkCount);
+        {
+            std::vector<std::thread> workers;
+            for (size_t c = 0; c < chunkCount; ++c)
+            {
+                workers.emplace_back([&, c]()
+                                     { lineCounts[c] = countRecords(bounds[c], bounds[c + 1]); });
+            }
+            for (auto &worker : workers)
+                worker.join();
+        }
+        for (size_t c = 0; c < chunkCount; ++c)
+            firstRecord[c + 1] = firstRecord[c] + lineCounts[c];
+
+        // 第二遍：每块解析到自己的列缓冲
+        {
+            std::vector<std::thread> workers;
+            for (size_t c = 0; c < chunkCount; ++c)
+            {
+                workers.emplace_back([&, c]()
+                                     {
+                    try
+                    {
+                        chunks[c].reserve(lineCounts[c]);
+                        parseRecords(bounds[c], bounds[c + 1], chunks[c], firstRecord[c]);
+                    }
+                    catch (...)
+                    {
+                        errors[c] = std::current_exception();
+                    } });
+            }
+            for (auto &worker : workers)
+                worker.join();
+        }
+        for (const auto &error : errors)
+        {
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        // 按块顺序拼接
+        size_t total = columns.size();
+        for (const auto &chunk : chunks)
+            total += chunk.size();
+        columns.reserve(total);
+        for (auto &chunk : chunks)
+        {
+            appendColumn(columns.parents, chunk.parents);
+            appendColumn(columns.g, chunk.g);
+            appendColumn(columns.h, chunk.h);
+            appendColumn(columns.f, chunk.f);
+            appendColumn(columns.states, chunk.states);
+        }
+    }
+}
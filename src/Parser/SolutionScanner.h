@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../Core/PuzzleState.h"
+#include <vector>
+#include <cstddef>
+
+// solution每一行是: size p g h f stateArray
+
+/**
+ * @brief 树形解决方案的列式存储
+ *
+ * 每条记录的各个字段分别存放在独立的列中，下标即记录编号
+ */
+struct SolutionColumns
+{
+    std::vector<PuzzleState> states; ///< 状态列
+    std::vector<int> parents;        ///< 父节点索引列
+    std::vector<int> g, h, f;        ///< g值、h值、f值列
+
+    /**
+     * @brief 为所有列预留空间
+     * @param count 记录数量
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief 获取记录数量
+     */
+    size_t size() const { return parents.size(); }
+};
+
+/**
+ * @brief 单条解析出的记录
+ */
+struct SolutionRecord
+{
+    int size;               ///< 棋盘边长
+    int parent;             ///< 父节点索引
+    int g, h, f;            ///< g值、h值、f值
+    std::vector<int> tiles; ///< 状态数组（size*size个）
+};
+
+/**
+ * @brief solution.txt 的快速扫描器
+ *
+ * 直接在内存缓冲区（通常是内存映射的文件）上解析整数，不经过iostream
+ */
+namespace SolutionScanner
+{
+    /**
+     * @brief 统计缓冲区中的记录行数（用于预分配列空间）
+     * @param begin 缓冲区起始
+     * @param end 缓冲区结束
+     * @return 行数（最后一行没有换行符时也计入）
+     */
+    size_t countRecords(const char *begin, const char *end);
+
+    /**
+     * @brief 从当前位置读取下一条记录
+     * @param p 当前位置，成功后推进到记录之后
+     * @param end 缓冲区结束
+     * @param record 输出记录
+     * @param recordIndex 记录编号（仅用于错误信息）
+     * @return 读到记录返回true，缓冲区中只剩空白时返回false
+     * @throws std::runtime_error 格式错误或记录被截断
+     */
+    bool readRecord(const char *&p, const char *end, SolutionRecord &record, size_t recordIndex);
+
+    /**
+     * @brief 解析缓冲区中的所有记录并追加到列中
+     * @param begin 缓冲区起始
+     * @param end 缓冲区结束
+     * @param columns 输出列
+     * @param firstRecord 缓冲区第一条记录在整个文件中的编号（仅用于错误信息）
+     * @throws std::runtime_error 格式错误或记录被截断
+     */
+    void parseRecords(const char *begin, const char *end, SolutionColumns &columns, size_t firstRecord = 0);
+
+    /**
+     * @brief 多线程解析缓冲区中的所有记录并追加到列中
+     *
+     * 缓冲区按换行符切分为若干块，每块由一个工作线程解析到独立的列缓冲，
+     * 最后按块顺序拼接，记录编号与串行解析完全一致。输入较小时直接串行解析。
+     * @param begin 缓冲区起始
+     * @param end 缓冲区结束
+     * @param columns 输出列
+     * @param threadCount 工作线程数，0表示使用硬件并发数
+     * @throws std::runtime_error 任一块格式错误
+     */
+    void parseRecordsParallel(const char *begin, const char *end, SolutionColumns &columns, unsigned threadCount = 0);
+}
@@ -0,0 +1,341 @@
+#include "SolutionValidator.h"
+#include "SolutionScanner.h"
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    // 每个线程至少处理的记录数，小区间直接串行
+    constexpr size_t PARALLEL_VALIDATE_MIN_RECORDS = 1 << 16;
+
+    // 每个分块最多保留的详细信息条数
+    constexpr size_t MAX_MESSAGES = 16;
+
+    constexpr uint64_t HIGH_BITS = 0x8080808080808080ull;
+
+    // 读取从tiles[i]开始的最多8个格子到一个64位字中，不足8个的部分填0xFF（既不是空格也不会产生差异）
+    uint64_t loadWord(const uint8_t *tiles, int i, int cells)
+    {
+        uint64_t word = ~uint64_t(0);
+        std::memcpy(&word, tiles + i, std::min(8, cells - i));
+        return word;
+    }
+
+    // 字内为0的字节对应位置的最高位置1
+    uint64_t zeroBytes(uint64_t word)
+    {
+        return ~(((word & ~HIGH_BITS) + ~HIGH_BITS) | word) & HIGH_BITS;
+    }
+
+    int blankIndex(uint64_t word, int i)
+    {
+        uint64_t zeros = zeroBytes(word);
+        int k = 0;
+        while (!(zeros & (uint64_t(0x80) << (8 * k))))
+            ++k;
+        return i + k;
+    }
+
+    // 只在还需要详细信息时才拼接字符串
+    void report(ValidationReport &result, size_t index, const char *what)
+    {
+        if (result.messages.size() < MAX_MESSAGES)
+            result.messages.push_back("record " + std::to_string(index) + ": " + what);
+    }
+
+    // 结构错误，第一条额外保存在firstError中
+    void reportError(ValidationReport &result, size_t index, const char *what, int parent = -1)
+    {
+        ++result.errors;
+        if (!result.firstError.empty() && result.messages.size() >= MAX_MESSAGES)
+            return;
+        std::string message = "record " + std::to_string(index) + ": " + what;
+        if (parent >= 0)
+            message += " " + std::to_string(parent);
+        if (result.firstError.empty())
+            result.firstError = message;
+        if (result.messages.size() < MAX_MESSAGES)
+            result.messages.push_back(std::move(message));
+    }
+
+    // 通过ISolution接口访问记录
+    struct SolutionRecords
+    {
+        const ISolution &solution;
+        const PuzzleState &state(int i) const { return solution.getState(i); }
+        int parent(int i) const { return solution.getParent(i); }
+        int g(int i) const { return solution.getG(i); }
+        int h(int i) const { return solution.getH(i); }
+        int f(int i) const { return solution.getF(i); }
+        size_t size() const { return solution.size(); }
+        bool complete() const { return solution.isComplete(); }
+    };
+
+    // 父节点和代价直接读连续列，只有状态仍通过接口访问
+    struct SpanRecords
+    {
+        const ISolution &solution;
+        ColumnSpan<int> parents, gs, hs, fs;
+        const PuzzleState &state(int i) const { return solution.getState(i); }
+        int parent(int i) const { return parents[i]; }
+        int g(int i) const { return gs[i]; }
+        int h(int i) const { return hs[i]; }
+        int f(int i) const { return fs[i]; }
+        size_t size() const { return parents.size(); }
+        bool complete() const { return solution.isComplete(); }
+    };
+
+    // 直接访问列（状态按引用返回，没有虚调用和拷贝）
+    struct ColumnRecords
+    {
+        const SolutionColumns &columns;
+        const PuzzleState &state(int i) const { return columns.states[i]; }
+        int parent(int i) const { return columns.parents[i]; }
+        int g(int i) const { return columns.g[i]; }
+        int h(int i) const { return columns.h[i]; }
+        int f(int i) const { return columns.f[i]; }
+        size_t size() const { return columns.size(); }
+        bool complete() const { return true; }
+    };
+
+    template <typename Records>
+    void validateChunk(const Records &records, size_t begin, size_t end, size_t available, ValidationReport &result)
+    {
+        bool complete = records.complete();
+        for (size_t i = begin; i < end; ++i)
+        {
+            int index = static_cast<int>(i);
+            const auto &state = records.state(index);
+            int cells = static_cast<int>(state.size());
+            ++result.checked;
+
+            if (!SolutionValidator::isPermutation(state.data(), cells))
+            {
+                reportError(result, i, "state is not a permutation of 0..n*n-1");
+                continue;
+            }
+
+            int g = records.g(index);
+            if (records.f(index) != g + records.h(index))
+            {
+                ++result.warnings;
+                report(result, i, "f != g + h");
+            }
+
+            int parent = records.parent(index);
+            if (parent == -1)
+                continue;
+            if (parent < -1 || parent == index || (complete && static_cast<size_t>(parent) >= available))
+            {
+                reportError(result, i, "missing parent");
+                continue;
+            }
+            if (static_cast<size_t>(parent) >= available)
+                continue; // 流式加载中父节点尚未到达
+
+            const auto &parentState = records.state(parent);
+            int n = 0;
+            while (n * n < cells)
+                ++n;
+            if (parentState.size() != state.size() || !SolutionValidator::isSingleMove(parentState.data(), state.data(), n))
+            {
+                reportError(result, i, "state is not one legal blank move from parent", parent);
+                continue;
+            }
+
+            if (g != records.g(parent) + 1)
+            {
+                ++result.warnings;
+                report(result, i, "g != parent g + 1");
+            }
+        }
+    }
+
+    // 逐条检查之后的全局检查：至少有一个根节点，父节点链不成环。
+    // 父节点可以在子节点之后出现，所以不能只要求parent < index；
+    // 每条父链只走一次（0=未访问，1=在当前链上，2=已确认能到达根节点），整体O(n)。
+    // 只在全部记录已到达、且逐条检查确认每个父索引都在范围内时进行
+    template <typename Records>
+    void validateLinks(const Records &records, ValidationReport &result)
+    {
+        if (!result.ok() || !records.complete())
+            return;
+
+        size_t count = records.size();
+        bool hasRoot = false;
+        for (size_t i = 0; i < count && !hasRoot; ++i)
+            hasRoot = records.parent(static_cast<int>(i)) == -1;
+        if (!hasRoot)
+        {
+            reportError(result, 0, "no root record (parent -1) in solution");
+            return;
+        }
+
+        std::vector<uint8_t> visit(count, 0);
+        std::vector<int> chain;
+        for (size_t i = 0; i < count; ++i)
+        {
+            int node = static_cast<int>(i);
+            while (node != -1 && visit[node] == 0)
+            {
+                visit[node] = 1;
+                chain.push_back(node);
+                node = records.parent(node);
+            }
+            if (node != -1 && visit[node] == 1)
+                reportError(result, static_cast<size_t>(node), "parent chain forms a cycle");
+            for (int visited : chain)
+                visit[visited] = 2;
+            chain.clear();
+        }
+    }
+
+    template <typename Records>
+    ValidationReport validateRecords(const Records &records, unsigned threadCount)
+    {
+        size_t available = records.size();
+        size_t begin = 0, end = available;
+        ValidationReport result;
+        if (begin >= end)
+            return result;
+
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        size_t count = end - begin;
+        size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threadCount, count / PARALLEL_VALIDATE_MIN_RECORDS));
+
+        if (chunkCount == 1)
+        {
+            validateChunk(records, begin, end, available, result);
+            validateLinks(records, result);
+            return result;
+        }
+
+        std::vector<ValidationReport> chunks(chunkCount);
+        std::vector<std::exception_ptr> errors(chunkCount);
+        std::vector<std::thread> workers;
+        for (size_t c = 0; c < chunkCount; ++c)
+        {
+            size_t first = begin + count * c / chunkCount;
+            size_t last = begin + count * (c + 1) / chunkCount;
+            workers.emplace_back([&, c, first, last]()
+                                 {
+                try
+                {
+                    validateChunk(records, first, last, available, chunks[c]);
+                }
+                catch (...)
+                {
+                    errors[c] = std::current_exception();
+                } });
+        }
+        for (auto &worker : workers)
+            worker.join();
+        for (auto &error : errors)
+            if (error)
+                std::rethrow_exception(error);
+
+        // 分块按记录顺序合并，详细信息仍然按记录编号排序
+        for (auto &chunk : chunks)
+        {
+            result.checked += chunk.checked;
+            result.errors += chunk.errors;
+            result.warnings += chunk.warnings;
+            if (result.firstError.empty())
+                result.firstError = std::move(chunk.firstError);
+            for (auto &message : chunk.messages)
+                if (result.messages.size() < MAX_MESSAGES)
+                    result.messages.push_back(std::move(message));
+        }
+        validateLinks(records, result);
+        return result;
+    }
+}
+
+namespace SolutionValidator
+{
+    // 用两个64位字作为位图（棋盘最大10x10），无分支地累积每个格子的出现情况，
+    // 编译器可以把循环展开/向量化，一次比较64个格子
+    bool isPermutation(const uint8_t *tiles, int cells)
+    {
+        uint64_t low = 0, high = 0;
+        uint8_t outOfRange = 0;
+        for (int i = 0; i < cells; ++i)
+        {
+            uint8_t v = tiles[i];
+            uint64_t bit = uint64_t(1) << (v & 63);
+            low |= v < 64 ? bit : 0;
+            high |= v >= 64 ? bit : 0;
+            outOfRange |= static_cast<uint8_t>(v >= cells);
+        }
+        uint64_t fullLow = cells >= 64 ? ~uint64_t(0) : (uint64_t(1) << cells) - 1;
+        uint64_t fullHigh = cells > 64 ? (uint64_t(1) << (cells - 64)) - 1 : 0;
+        return !outOfRange && low == fullLow && high == fullHigh;
+    }
+
+    // 子状态是否恰好由父状态移动一次空格得到。每次比较8个格子（字内并行），
+    // 调用前两个状态都已确认是排列，因此恰好两个格子不同且互换即为一次移动
+    bool isSingleMove(const uint8_t *parent, const uint8_t *child, int n)
+    {
+        int cells = n * n;
+        size_t diff = 0;
+        int from = -1, to = -1;
+        for (int i = 0; i < cells; i += 8)
+        {
+            uint64_t a = loadWord(parent, i, cells);
+            uint64_t b = loadWord(child, i, cells);
+            diff += std::bitset<64>(~zeroBytes(a ^ b) & HIGH_BITS).count();
+            if (zeroBytes(a))
+                from = blankIndex(a, i);
+            if (zeroBytes(b))
+                to = blankIndex(b, i);
+        }
+        if (diff != 2 || from < 0 || to < 0 || parent[to] != child[from])
+            return false;
+
+        int dr = from / n - to / n, dc = from % n - to % n;
+        return (dr == 0 && (dc == 1 || dc == -1)) || (dc == 0 && (dr == 1 || dr == -1));
+    }
+
+    ValidationReport validate(const ISolution &solution, unsigned threadCount)
+    {
+        size_t count = solution.size();
+        SpanRecords spans{solution, solution.getParentColumn(), solution.getGColumn(),
+                          solution.getHColumn(), solution.getFColumn()};
+        if (spans.parents.size() == count && spans.gs.size() == count &&
+            spans.hs.size() == count && spans.fs.size() == count)
+            return validateRecords(spans, threadCount);
+        return validateRecords(SolutionRecords{solution}, threadCount);
+    }
+
+    ValidationReport validate(const SolutionColumns &columns, unsigned threadCount)
+    {
+        return validateRecords(ColumnRecords{columns}, threadCount);
+    }
+
+    std::string summary(const ValidationReport &report)
+    {
+        std::string text = "Validated " + std::to_string(report.checked) + " records: " +
+                           std::to_string(report.errors) + " errors, " +
+                           std::to_string(report.warnings) + " cost warnings";
+        if (!report.firstError.empty())
+            text += " (first error: " + report.firstError + ")";
+        else if (!report.messages.empty())
+            text += " (first: " + report.messages.front() + ")";
+        return text;
+    }
+
+    void requireValid(const ValidationReport &report, const std::string &path)
+    {
+        if (!report.ok())
+            throw std::runtime_error("Solution file " + path + " failed validation: " + summary(report));
+        if (report.warnings > 0)
+            std::cout << summary(report) << std::endl;
+    }
+}
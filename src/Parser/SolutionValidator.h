@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Solution.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct SolutionColumns;
+
+/**
+ * @brief 解决方案校验结果
+ */
+struct ValidationReport
+{
+    size_t checked = 0;                ///< 已检查的记录数
+    size_t errors = 0;                 ///< 结构错误数（非排列、父节点不存在、非法移动、无根节点、成环）
+    size_t warnings = 0;               ///< 代价不一致数（g != 父节点g + 1 或 f != g + h）
+    std::vector<std::string> messages; ///< 前若干条问题的详细信息（按记录编号排序）
+    std::string firstError;            ///< 第一条结构错误的详细信息
+
+    /**
+     * @brief 是否没有结构错误
+     */
+    bool ok() const { return errors == 0; }
+};
+
+/**
+ * @brief 搜索轨迹的语义校验
+ *
+ * 按记录区间多线程检查：
+ * - 每个状态都是0..n*n-1的排列
+ * - 父节点索引存在（-1表示根节点）
+ * - 子状态与父状态恰好相差一次合法的空格移动
+ * - g等于父节点g加1，f等于g加h（只计为警告，部分求解器输出的代价不满足该约定）
+ *
+ * 全部记录到达后再串行检查一次：至少存在一个根节点，父节点链不成环
+ */
+namespace SolutionValidator
+{
+    /**
+     * @brief 状态是否是0..cells-1的排列
+     * @param tiles 状态数组
+     * @param cells 格子数
+     */
+    bool isPermutation(const uint8_t *tiles, int cells);
+
+    /**
+     * @brief 子状态是否恰好由父状态移动一次空格得到（两个状态都须已确认是排列）
+     * @param parent 父状态数组
+     * @param child 子状态数组
+     * @param n 棋盘边长
+     */
+    bool isSingleMove(const uint8_t *parent, const uint8_t *child, int n);
+
+    /**
+     * @brief 校验全部记录
+     * @param solution 解决方案
+     * @param threadCount 线程数，0表示使用硬件并发数
+     * @return 校验结果
+     *
+     * 尚未加载完成（流式加载中）时，父节点尚未到达的记录跳过与父节点相关的检查
+     */
+    ValidationReport validate(const ISolution &solution, unsigned threadCount = 0);
+
+    /**
+     * @brief 直接校验解析出的列（无虚调用、不拷贝状态）
+     */
+    ValidationReport validate(const SolutionColumns &columns, unsigned threadCount = 0);
+
+    /**
+     * @brief 生成一行摘要
+     */
+    std::string summary(const ValidationReport &report);
+
+    /**
+     * @brief 有结构错误时抛出异常，只有代价警告时输出摘要
+     * @param report 校验结果
+     * @param path 文件路径（用于错误信息）
+     * @throws std::runtime_error 存在结构错误
+     */
+    void requireValid(const ValidationReport &report, const std::string &path);
+}
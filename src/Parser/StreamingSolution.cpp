@@ -0,0 +1,383 @@
+#include "StreamingSolution.h"
+#include "SolutionValidator.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+    // 每解析这么多条记录发布一次
+    constexpr size_t PUBLISH_INTERVAL = 256;
+
+    // 跟随模式每次最多读取的字节数
+    constexpr size_t FOLLOW_READ_BYTES = 4 * 1024 * 1024;
+
+    // 跟随模式文件没有增长时的轮询间隔
+    constexpr auto FOLLOW_POLL_INTERVAL = std::chrono::milliseconds(200);
+
+    // 跟随模式文件这么久没有增长时视为求解器已写完
+    constexpr auto FOLLOW_IDLE_TIMEOUT = std::chrono::seconds(10);
+}
+
+StreamingSolution::StreamingSolution(const std::string &filepath, bool followFile)
+    : filePath(filepath), follow(followFile), checkpointCount(0), boardSize(0), published(0), complete(false),
+      failed(false), stopRequested(false)
+{
+    if (follow)
+    {
+        if (!std::ifstream(filePath).is_open())
+            throw std::runtime_error("Cannot open file: " + filePath);
+    }
+    else
+    {
+        file = std::make_unique<MappedFile>(filePath);
+    }
+
+    // 块目录一次分配，后台线程只填充其中的指针，目录本身不会扩容
+    blocks.resize(MAX_BLOCKS);
+    checkpointBlocks.resize(MAX_BLOCKS);
+
+    worker = std::thread(&StreamingSolution::parseInBackground, this);
+}
+
+StreamingSolution::~StreamingSolution()
+{
+    stopRequested.store(true);
+    if (worker.joinable())
+        worker.join();
+}
+
+void StreamingSolution::parseInBackground()
+{
+    size_t count = 0;
+    try
+    {
+        if (follow)
+            followInBackground(count);
+        else
+            parseBuffer(file->begin(), file->end(), count);
+        if (!stopRequested.load(std::memory_order_relaxed))
+            checkForwardRecords(count, true);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Streaming load stopped after " << count << " records: " << e.what() << std::endl;
+        failed.store(true, std::memory_order_release);
+    }
+
+    publish(count);
+    complete.store(true, std::memory_order_release);
+    waitCondition.notify_all();
+}
+
+void StreamingSolution::followInBackground(size_t &count)
+{
+    std::ifstream in(filePath, std::ios::binary);
+    uint64_t offset = 0;       // 已读取的字节数
+    std::string pending;       // 上次读取末尾不完整的行
+    std::vector<char> buffer(FOLLOW_READ_BYTES);
+    auto lastGrowth = std::chrono::steady_clock::now();
+
+    while (!stopRequested.load(std::memory_order_relaxed))
+    {
+        // 文件被截断说明求解器重新开始了一次搜索，无法再追加到当前树上
+        std::error_code ec;
+        uint64_t fileSize = std::filesystem::file_size(filePath, ec);
+        if (!ec && fileSize < offset)
+            throw std::runtime_error("solution file was truncated, reopen Tree View to follow the new search");
+
+        std::streamsize got = 0;
+        if (!ec && fileSize > offset)
+        {
+            in.clear();
+            in.seekg(static_cast<std::streamoff>(offset));
+            in.read(buffer.data(), static_cast<std::streamsize>(std::min<uint64_t>(buffer.size(), fileSize - offset)));
+            got = in.gcount();
+        }
+        if (got <= 0)
+        {
+            if (std::chrono::steady_clock::now() - lastGrowth >= FOLLOW_IDLE_TIMEOUT)
+                break;
+            std::this_thread::sleep_for(FOLLOW_POLL_INTERVAL);
+            continue;
+        }
+        lastGrowth = std::chrono::steady_clock::now();
+        offset += static_cast<uint64_t>(got);
+        pending.append(buffer.data(), static_cast<size_t>(got));
+
+        // 只解析到最后一个换行符，求解器正在写的半行留到下次
+        size_t lastNewline = pending.rfind('\n');
+        if (lastNewline == std::string::npos)
+            continue;
+        parseBuffer(pending.data(), pending.data() + lastNewline + 1, count);
+        pending.erase(0, lastNewline + 1);
+
+        // 父节点已在本批到达的前向记录现在就检查，不必等到跟随结束
+        checkForwardRecords(count, false);
+        publish(count);
+    }
+
+    // 求解器写完时最后一条记录可能没有换行符；仍是半行时按截断的记录报错
+    if (!stopRequested.load(std::memory_order_relaxed))
+        parseBuffer(pending.data(), pending.data() + pending.size(), count);
+}
+
+void StreamingSolution::parseBuffer(const char *begin, const char *end, size_t &count)
+{
+    SolutionRecord record;
+    const char *p = begin;
+    while (!stopRequested.load(std::memory_order_relaxed) &&
+           SolutionScanner::readRecord(p, end, record, count))
+    {
+        storeRecord(record, count);
+        ++count;
+        if (count % PUBLISH_INTERVAL == 0)
+            publish(count);
+    }
+}
+
+void StreamingSolution::storeRecord(const SolutionRecord &record, size_t index)
+{
+    if (index == 0)
+        boardSize.store(record.size, std::memory_order_relaxed);
+    else if (record.size != boardSize.load(std::memory_order_relaxed))
+        throw std::runtime_error("Solution file format error: record " + std::to_string(index) +
+                                 " has a different board size");
+
+    size_t blockIndex = index / BLOCK_SIZE;
+    size_t slot = index % BLOCK_SIZE;
+    if (blockIndex >= blocks.size())
+        throw std::runtime_error("Solution file is too large: record " + std::to_string(index));
+    if (!blocks[blockIndex])
+    {
+        auto block = std::make_unique<Block>();
+        block->parents.resize(BLOCK_SIZE);
+        block->g.resize(BLOCK_SIZE);
+        block->h.resize(BLOCK_SIZE);
+        block->f.resize(BLOCK_SIZE);
+        block->moves.resize(BLOCK_SIZE);
+        blocks[blockIndex] = std::move(block);
+    }
+
+    // 发布前逐条做结构校验，出错的记录不会被发布，后台加载在此停止
+    int cells = static_cast<int>(record.tiles.size());
+    uint8_t tiles[100];
+    for (int i = 0; i < cells; ++i)
+        tiles[i] = static_cast<uint8_t>(record.tiles[i]); // 扫描时已确认在0..255之间
+    if (!SolutionValidator::isPermutation(tiles, cells))
+        throw std::runtime_error("Solution validation error: record " + std::to_string(index) + " is not a permutation");
+    if (record.parent < -1 || record.parent == static_cast<int>(index))
+        throw std::runtime_error("Solution validation error: record " + std::to_string(index) + " has an invalid parent");
+
+    // 父节点已到达时只记录一步空格移动，距检查点达到间隔时改存完整状态
+    uint8_t move = CHECKPOINT;
+    if (record.parent >= 0 && static_cast<size_t>(record.parent) < index)
+    {
+        uint8_t parentTiles[100];
+        rebuildTiles(record.parent, parentTiles, true);
+        if (!SolutionValidator::isSingleMove(parentTiles, tiles, record.size))
+            throw std::runtime_error("Solution validation error: record " + std::to_string(index) +
+                                     " is not one legal blank move from its parent");
+
+        uint8_t parentMove = blocks[record.parent / BLOCK_SIZE]->moves[record.parent % BLOCK_SIZE];
+        int hops = parentMove == CHECKPOINT ? 1 : (parentMove >> 2) + 1;
+        if (hops < CHECKPOINT_INTERVAL)
+        {
+            int from = static_cast<int>(std::find(parentTiles, parentTiles + cells, 0) - parentTiles);
+            int to = static_cast<int>(std::find(tiles, tiles + cells, 0) - tiles);
+            const int offsets[4] = {-record.size, record.size, -1, 1};
+            int code = static_cast<int>(std::find(offsets, offsets + 4, to - from) - offsets);
+            move = static_cast<uint8_t>(hops << 2 | code);
+        }
+    }
+    else if (record.parent >= 0)
+    {
+        forwardRecords.push_back(static_cast<int>(index)); // 父节点尚未到达，解析结束时再检查
+    }
+    if (move == CHECKPOINT)
+        storeCheckpoint(index, tiles, cells);
+
+    if (recentNodes.empty())
+    {
+        recentNodes.assign(RECENT_STATES, -1);
+        recentTiles.resize(RECENT_STATES * cells);
+    }
+    recentNodes[index % RECENT_STATES] = static_cast<int>(index);
+    std::copy(tiles, tiles + cells, recentTiles.begin() + (index % RECENT_STATES) * cells);
+
+    Block &block = *blocks[blockIndex];
+    block.parents[slot] = record.parent;
+    block.g[slot] = record.g;
+    block.h[slot] = record.h;
+    block.f[slot] = record.f;
+    block.moves[slot] = move;
+}
+
+void StreamingSolution::checkForwardRecords(size_t count, bool final)
+{
+    uint8_t tiles[100], parentTiles[100];
+    size_t waiting = 0;
+    for (size_t i = 0; i < forwardRecords.size(); ++i)
+    {
+        int index = forwardRecords[i];
+        int parent = getParent(index);
+        if (static_cast<size_t>(parent) >= count)
+        {
+            if (final)
+                throw std::runtime_error("Solution validation error: record " + std::to_string(index) + " has an invalid parent");
+            forwardRecords[waiting++] = index; // 跟随模式中父节点可能还没写出
+            continue;
+        }
+        rebuildTiles(index, tiles);
+        rebuildTiles(parent, parentTiles);
+        if (!SolutionValidator::isSingleMove(parentTiles, tiles, boardSize.load(std::memory_order_relaxed)))
+            throw std::runtime_error("Solution validation error: record " + std::to_string(index) +
+                                     " is not one legal blank move from its parent");
+    }
+    forwardRecords.resize(waiting);
+}
+
+void StreamingSolution::storeCheckpoint(size_t index, const uint8_t *tiles, int cells)
+{
+    size_t count = checkpointCount.load(std::memory_order_relaxed);
+    size_t blockIndex = count / BLOCK_SIZE;
+    size_t slot = count % BLOCK_SIZE;
+    if (!checkpointBlocks[blockIndex])
+    {
+        auto block = std::make_unique<CheckpointBlock>();
+        block->nodes.resize(BLOCK_SIZE);
+        block->tiles.resize(BLOCK_SIZE * cells);
+        checkpointBlocks[blockIndex] = std::move(block);
+    }
+
+    CheckpointBlock &block = *checkpointBlocks[blockIndex];
+    block.nodes[slot] = static_cast<int>(index);
+    std::copy(tiles, tiles + cells, block.tiles.begin() + slot * cells);
+    checkpointCount.store(count + 1, std::memory_order_release);
+}
+
+const uint8_t *StreamingSolution::checkpointTiles(int index) const
+{
+    // 检查点按记录编号递增追加，二分查找
+    size_t low = 0, high = checkpointCount.load(std::memory_order_acquire);
+    while (low < high)
+    {
+        size_t middle = (low + high) / 2;
+        if (checkpointBlocks[middle / BLOCK_SIZE]->nodes[middle % BLOCK_SIZE] < index)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    int cells = boardSize.load(std::memory_order_relaxed);
+    cells *= cells;
+    return checkpointBlocks[low / BLOCK_SIZE]->tiles.data() + (low % BLOCK_SIZE) * cells;
+}
+
+void StreamingSolution::rebuildTiles(int index, uint8_t *tiles, bool useRecent) const
+{
+    int n = boardSize.load(std::memory_order_relaxed);
+    int cells = n * n;
+
+    // 沿父节点链向上收集移动，直到遇到检查点（或最近解析过的状态）
+    uint8_t path[CHECKPOINT_INTERVAL];
+    int length = 0;
+    int node = index;
+    const uint8_t *start = nullptr;
+    while (!start)
+    {
+        size_t recent = static_cast<size_t>(node) % RECENT_STATES;
+        uint8_t move = blocks[node / BLOCK_SIZE]->moves[node % BLOCK_SIZE];
+        if (useRecent && recentNodes[recent] == node)
+            start = recentTiles.data() + recent * cells;
+        else if (move == CHECKPOINT)
+            start = checkpointTiles(node);
+        else
+        {
+            path[length++] = move & 3;
+            node = getParent(node);
+        }
+    }
+    std::copy(start, start + cells, tiles);
+
+    // 从检查点向下回放移动
+    int blank = static_cast<int>(std::find(tiles, tiles + cells, 0) - tiles);
+    const int offsets[4] = {-n, n, -1, 1};
+    for (int i = length - 1; i >= 0; --i)
+    {
+        int target = blank + offsets[path[i]];
+        tiles[blank] = tiles[target];
+        tiles[target] = 0;
+        blank = target;
+    }
+}
+
+void StreamingSolution::publish(size_t count)
+{
+    {
+        std::lock_guard<std::mutex> lock(waitMutex);
+        published.store(count, std::memory_order_release);
+    }
+    waitCondition.notify_all();
+}
+
+size_t StreamingSolution::waitForRecords(size_t count) const
+{
+    std::unique_lock<std::mutex> lock(waitMutex);
+    waitCondition.wait(lock, [&]()
+                       { return published.load(std::memory_order_acquire) >= count ||
+                                complete.load(std::memory_order_acquire); });
+    return published.load(std::memory_order_acquire);
+}
+
+PuzzleState StreamingSolution::decodeState(int index) const
+{
+    int cells = boardSize.load(std::memory_order_relaxed);
+    cells *= cells;
+    uint8_t tiles[100];
+    rebuildTiles(index, tiles);
+    return PuzzleState(tiles, cells);
+}
+
+size_t StreamingSolution::memoryBytes() const
+{
+    // 只读原子计数，不访问后台线程可能正在修改的容器
+    size_t cells = static_cast<size_t>(boardSize.load(std::memory_order_relaxed));
+    cells *= cells;
+    size_t recordBlocks = (published.load(std::memory_order_acquire) + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    size_t checkpointBlockCount = (checkpointCount.load(std::memory_order_acquire) + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    size_t bytes = sizeof(*this) + 2 * MAX_BLOCKS * sizeof(std::unique_ptr<Block>);
+    bytes += recordBlocks * BLOCK_SIZE * (4 * sizeof(int) + sizeof(uint8_t));
+    bytes += checkpointBlockCount * BLOCK_SIZE * (sizeof(int) + cells);
+    bytes += RECENT_STATES * (sizeof(int) + cells);
+    return bytes;
+}
+
+std::vector<int> StreamingSolution::getPathToRoot(int index) const
+{
+    std::vector<int> path;
+    while (index != -1)
+    {
+        path.push_back(index);
+        index = getParent(index);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::unique_ptr<ISolution> loadSolutionTreeStreaming(const std::string &path)
+{
+    auto solution = std::make_unique<StreamingSolution>(path);
+    if (solution->waitForRecords(1) == 0)
+        throw std::runtime_error("Solution file is empty or invalid: " + path);
+    return solution;
+}
+
+std::unique_ptr<ISolution> followSolutionTree(const std::string &path)
+{
+    std::cout << "Following " << path << std::endl;
+    return std::make_unique<StreamingSolution>(path, true);
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "Solution.h"
+#include "MappedFile.h"
+#include "SolutionScanner.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief 流式加载的树形解决方案
+ *
+ * 构造后立即返回，后台线程在内存映射的文件上逐条解析记录并按块发布。
+ * size()只统计已发布的记录，已发布的记录不会再移动，UI线程可以边读边显示。
+ * 状态与DeltaSolution一样差分编码：每条记录只存相对父节点的一次空格移动（1字节），
+ * 根节点、父节点尚未到达的记录以及沿父节点链每CHECKPOINT_INTERVAL层保存一个完整状态作为检查点，
+ * decodeState从最近的祖先检查点回放不超过CHECKPOINT_INTERVAL步重建状态，getState把结果放入线程内的环形缓冲区返回引用。
+ * 跟随模式下后台线程不映射文件，而是从上次的偏移继续读取外部求解器追加的字节，
+ * 只解析完整的行，直到文件10秒没有增长（视为求解器已写完）或对象析构。所有记录必须具有相同的棋盘大小。
+ * 遇到格式或结构错误时后台线程停止，isComplete()与hasFailed()都返回true，
+ * 此前发布的记录仍然可用。
+ */
+class StreamingSolution : public ISolution {
+private:
+    /// 每块记录数（块一旦分配地址固定）
+    static constexpr size_t BLOCK_SIZE = 1 << 16;
+
+    /// 块目录容量（目录一次分配，不会扩容）
+    static constexpr size_t MAX_BLOCKS = 1 << 15;
+
+    /// 沿父节点链相邻两个检查点之间的最大层数
+    static constexpr int CHECKPOINT_INTERVAL = 16;
+
+    /// 移动编码中表示该记录保存了完整状态
+    static constexpr uint8_t CHECKPOINT = 0xFF;
+
+    /// 后台线程保留的最近解析状态数（按记录编号直接映射）
+    static constexpr size_t RECENT_STATES = 1 << 14;
+
+    /// 一块记录的列存储
+    struct Block
+    {
+        std::vector<int> parents;
+        std::vector<int> g, h, f;
+        std::vector<uint8_t> moves; ///< 低2位为相对父节点的空格移动，其余位为距最近检查点的层数；CHECKPOINT表示检查点
+    };
+
+    /// 一块检查点（按记录编号递增追加）
+    struct CheckpointBlock
+    {
+        std::vector<int> nodes;     ///< 检查点的记录编号
+        std::vector<uint8_t> tiles; ///< 检查点状态，每个 boardSize*boardSize 字节
+    };
+
+    std::string filePath;                         ///< 解决方案文件路径
+    bool follow;                                  ///< 是否跟随文件增长
+    std::unique_ptr<MappedFile> file;             ///< 映射的 solution.txt（跟随模式下为空）
+    std::vector<std::unique_ptr<Block>> blocks;   ///< 块目录（一次分配）
+    std::vector<std::unique_ptr<CheckpointBlock>> checkpointBlocks; ///< 检查点块目录（一次分配）
+    std::atomic<size_t> checkpointCount;          ///< 已写入的检查点数（先于记录发布）
+    std::vector<int> recentNodes;                 ///< 最近解析状态的记录编号（只由后台线程访问）
+    std::vector<uint8_t> recentTiles;             ///< 最近解析的状态，编码父节点时多数不必回放到检查点
+    std::vector<int> forwardRecords;              ///< 父节点在后面的记录编号（只由后台线程访问，父节点到达后检查）
+    std::atomic<int> boardSize;                   ///< 棋盘边长（首条记录解析后确定）
+    std::atomic<size_t> published;                ///< 已发布的记录数
+    std::atomic<bool> complete;                   ///< 后台解析是否结束
+    std::atomic<bool> failed;                     ///< 后台解析是否因错误提前结束（先于complete写入）
+    std::atomic<bool> stopRequested;              ///< 请求后台线程退出
+
+    mutable std::mutex waitMutex;                 ///< 配合waitCondition等待发布
+    mutable std::condition_variable waitCondition;
+
+    std::thread worker;                           ///< 后台解析线程
+
+    /**
+     * @brief 后台解析主循环
+     */
+    void parseInBackground();
+
+    /**
+     * @brief 跟随模式的后台主循环：轮询文件增长并解析新增的完整行
+     *
+     * 文件10秒没有增长时视为求解器已写完，解析末尾没有换行符的最后一条记录后返回
+     * @param count 已解析的记录数，随解析推进
+     */
+    void followInBackground(size_t &count);
+
+    /**
+     * @brief 解析[begin,end)中的记录并写入块存储
+     * @param begin 缓冲区起始
+     * @param end 缓冲区结束
+     * @param count 已解析的记录数，随解析推进
+     */
+    void parseBuffer(const char *begin, const char *end, size_t &count);
+
+    /**
+     * @brief 把一条记录写入块存储（不发布）
+     * @param record 记录
+     * @param index 记录编号
+     */
+    void storeRecord(const SolutionRecord &record, size_t index);
+
+    /**
+     * @brief 追加一个检查点（不发布）
+     * @param index 记录编号
+     * @param tiles 完整状态
+     * @param cells 格子数
+     */
+    void storeCheckpoint(size_t index, const uint8_t *tiles, int cells);
+
+    /**
+     * @brief 检查父节点在后面的记录：父节点存在且恰好差一次空格移动，检查过的记录从forwardRecords中移除
+     * @param count 已解析的记录数
+     * @param final 是否已解析完全部记录（此时父节点仍未到达即为错误，否则留到下一批再检查）
+     * @throws std::runtime_error 结构校验失败
+     */
+    void checkForwardRecords(size_t count, bool final);
+
+    /**
+     * @brief 检查点记录的完整状态
+     * @param index 检查点的记录编号
+     */
+    const uint8_t *checkpointTiles(int index) const;
+
+    /**
+     * @brief 从最近的祖先检查点回放移动，重建已写入记录的状态
+     * @param index 记录编号
+     * @param tiles 输出状态（boardSize*boardSize字节）
+     * @param useRecent 是否可以从最近解析的状态开始回放（只有后台线程可以为true）
+     */
+    void rebuildTiles(int index, uint8_t *tiles, bool useRecent = false) const;
+
+    /**
+     * @brief 发布已解析的记录并唤醒等待者
+     * @param count 新的已发布记录数
+     */
+    void publish(size_t count);
+
+public:
+    /**
+     * @brief 构造函数，启动后台解析
+     * @param filepath 解决方案文件路径
+     * @param followFile 是否持续跟随文件增长
+     * @throws std::runtime_error 文件无法打开
+     */
+    StreamingSolution(const std::string &filepath, bool followFile = false);
+
+    /**
+     * @brief 析构函数，停止并等待后台线程
+     */
+    ~StreamingSolution();
+
+    const PuzzleState &getState(int index) const override { return keepDecoded(decodeState(index)); }
+    PuzzleState decodeState(int index) const override;
+    int getParent(int index) const override { return blocks[index / BLOCK_SIZE]->parents[index % BLOCK_SIZE]; }
+    int getG(int index) const override { return blocks[index / BLOCK_SIZE]->g[index % BLOCK_SIZE]; }
+    int getH(int index) const override { return blocks[index / BLOCK_SIZE]->h[index % BLOCK_SIZE]; }
+    int getF(int index) const override { return blocks[index / BLOCK_SIZE]->f[index % BLOCK_SIZE]; }
+    size_t size() const override { return published.load(std::memory_order_acquire); }
+    bool isComplete() const override { return complete.load(std::memory_order_acquire); }
+    bool hasFailed() const override { return failed.load(std::memory_order_acquire); }
+
+    std::vector<int> getPathToRoot(int index) const override;
+
+    /**
+     * @brief 已分配的块、检查点块、块目录和后台线程的最近状态缓冲区（加载中也可调用）
+     */
+    size_t memoryBytes() const override;
+
+    /**
+     * @brief 阻塞直到至少发布count条记录或解析结束
+     * @param count 需要的记录数
+     * @return 已发布的记录数
+     */
+    size_t waitForRecords(size_t count) const;
+};
+
+/**
+ * @brief 以流式方式加载树形解决方案
+ *
+ * 返回时至少已有一条记录可用（或文件已解析完毕）
+ * @param path 解决方案文件路径
+ * @return 指向ISolution的智能指针
+ */
+std::unique_ptr<ISolution> loadSolutionTreeStreaming(const std::string &path);
+
+/**
+ * @brief 以跟随模式加载树形解决方案
+ *
+ * 持续读取外部求解器追加到文件末尾的记录，跟随期间isComplete()返回false；
+ * 文件10秒没有增长时视为求解器已写完，完成最后的检查后isComplete()返回true。
+ * 立即返回，不等待求解器写出第一条记录（此时size()为0，由调用方逐帧轮询）
+ * @param path 解决方案文件路径
+ * @return 指向ISolution的智能指针
+ */
+std::unique_ptr<ISolution> followSolutionTree(const std::string &path);
@@ -0,0 +1,126 @@
+#include "TranspositionIndex.h"
+#include "../Core/Zobrist.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace
+{
+    constexpr uint8_t NO_BLANK = 0xFF;
+
+    int findBlank(const uint8_t *tiles, int cells)
+    {
+        const void *blank = std::memchr(tiles, 0, cells);
+        return blank ? static_cast<int>(static_cast<const uint8_t *>(blank) - tiles) : NO_BLANK;
+    }
+
+    bool adjacent(int a, int b, int n)
+    {
+        int dr = a / n - b / n, dc = a % n - b % n;
+        return (dr == 0 && (dc == 1 || dc == -1)) || (dc == 0 && (dr == 1 || dr == -1));
+    }
+}
+
+TranspositionIndex::TranspositionIndex(const ISolution &solution)
+{
+    size_t count = solution.size();
+    hashes.resize(count);
+    canonicals.resize(count);
+    if (count == 0)
+        return;
+
+    // 状态列可用时直接引用列中元素（无虚调用、不复制）；否则由getState解码，
+    // 每次循环最多同时持有两个解码结果，远少于其线程内环形缓冲区的槽位数
+    ColumnSpan<PuzzleState> stateColumn = solution.getStateColumn();
+    bool contiguous = stateColumn.size() == count;
+    auto stateAt = [&](int i) -> const PuzzleState & { return contiguous ? stateColumn[i] : solution.getState(i); };
+
+    int cells = solution.getState(0).size();
+    if (cells > Zobrist::MAX_CELLS)
+        throw std::runtime_error("Transposition index supports at most " + std::to_string(Zobrist::MAX_CELLS) + " cells");
+    int n = 0;
+    while (n * n < cells)
+        ++n;
+
+    // 每条记录的空格位置，增量更新只需父记录的空格位置而不必再读父状态
+    std::vector<uint8_t> blanks(count, NO_BLANK);
+    std::unordered_map<uint64_t, int> firstByHash;
+    firstByHash.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        int index = static_cast<int>(i);
+        const PuzzleState &state = stateAt(index);
+        const uint8_t *tiles = state.data();
+        int blank = findBlank(tiles, cells);
+        blanks[i] = static_cast<uint8_t>(blank);
+
+        // 父记录已处理且两者恰好相差一次空格移动（加载时已校验）时增量更新
+        int parent = solution.getParent(index);
+        int parentBlank = parent >= 0 && parent < index ? blanks[parent] : NO_BLANK;
+        if (state.size() == cells && blank != NO_BLANK && parentBlank != NO_BLANK &&
+            adjacent(parentBlank, blank, n))
+        {
+            hashes[i] = Zobrist::moveBlank(hashes[parent], parentBlank, blank, tiles[parentBlank]);
+            ++incrementalCount;
+        }
+        else
+        {
+            hashes[i] = Zobrist::hash(tiles, state.size());
+        }
+
+        // 哈希相同时再比较状态，碰撞的记录单独作为代表
+        auto [it, inserted] = firstByHash.emplace(hashes[i], index);
+        canonicals[i] = inserted || stateAt(it->second) != state ? index : it->second;
+    }
+
+    // 按代表记录分组，只保留重复的组
+    std::vector<int> groupSize(count, 0);
+    for (size_t i = 0; i < count; ++i)
+        groupSize[canonicals[i]]++;
+
+    std::vector<int> groupOf(count, -1);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (canonicals[i] != static_cast<int>(i))
+            continue;
+        ++uniqueCount;
+        if (groupSize[i] > 1)
+        {
+            groupOf[i] = static_cast<int>(groups.size());
+            groups.push_back({static_cast<int>(i), {}});
+            groups.back().members.reserve(groupSize[i]);
+        }
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        int group = groupOf[canonicals[i]];
+        if (group >= 0)
+            groups[group].members.push_back(static_cast<int>(i));
+    }
+}
+
+double TranspositionIndex::duplicationFactor() const
+{
+    return uniqueCount > 0 ? static_cast<double>(canonicals.size()) / uniqueCount : 1.0;
+}
+
+std::string TranspositionIndex::getStats() const
+{
+    size_t largest = 0;
+    for (const auto &group : groups)
+        largest = std::max(largest, group.members.size());
+
+    std::ostringstream oss;
+    oss << "Transposition Statistics:\n"
+        << "  Records: " << canonicals.size() << "\n"
+        << "  Unique States: " << uniqueCount << "\n"
+        << "  Duplicate Records: " << (canonicals.size() - uniqueCount) << "\n"
+        << "  Duplicate Groups: " << groups.size() << "\n"
+        << "  Largest Group: " << largest << "\n"
+        << "  Duplication Factor: " << duplicationFactor() << "\n"
+        << "  Incremental Hashes: " << incrementalCount;
+    return oss.str();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Solution.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 一组状态相同的记录
+ */
+struct DuplicateGroup
+{
+    int canonical;            ///< 代表记录（该状态第一次出现的记录）
+    std::vector<int> members; ///< 所有状态相同的记录（升序，包括代表记录）
+};
+
+/**
+ * @brief 搜索轨迹的置换索引
+ *
+ * 对解决方案中的所有状态计算Zobrist哈希：子记录与父记录恰好相差一次空格移动时
+ * 由父记录哈希增量得到，否则完整计算。哈希相同的记录再比较状态确认，
+ * 因此不同状态即使哈希碰撞也不会被合并。
+ * 每条记录映射到与其状态相同的第一条记录（代表记录），用于统计重复展开和构建合并后的DAG视图。
+ */
+class TranspositionIndex
+{
+public:
+    /**
+     * @brief 构造函数，为所有记录建立索引
+     * @param solution 解决方案（须已加载完成）
+     */
+    explicit TranspositionIndex(const ISolution &solution);
+
+    /**
+     * @brief 获取记录状态的Zobrist哈希
+     */
+    uint64_t hashOf(int index) const { return hashes[index]; }
+
+    /**
+     * @brief 获取与记录状态相同的代表记录
+     */
+    int canonical(int index) const { return canonicals[index]; }
+
+    /**
+     * @brief 记录是否为代表记录
+     */
+    bool isCanonical(int index) const { return canonicals[index] == index; }
+
+    /**
+     * @brief 获取所有包含两条及以上记录的重复组（按代表记录升序）
+     */
+    const std::vector<DuplicateGroup> &getDuplicateGroups() const { return groups; }
+
+    /**
+     * @brief 记录数
+     */
+    size_t size() const { return canonicals.size(); }
+
+    /**
+     * @brief 不同状态数
+     */
+    size_t uniqueStates() const { return uniqueCount; }
+
+    /**
+     * @brief 重复倍数（记录数 / 不同状态数）
+     */
+    double duplicationFactor() const;
+
+    /**
+     * @brief 获取统计信息
+     * @return 统计信息字符串
+     */
+    std::string getStats() const;
+
+private:
+    std::vector<uint64_t> hashes;       ///< 每条记录的哈希
+    std::vector<int> canonicals;        ///< 每条记录的代表记录
+    std::vector<DuplicateGroup> groups; ///< 重复组
+    size_t uniqueCount = 0;             ///< 不同状态数
+    size_t incrementalCount = 0;        ///< 增量计算哈希的记录数
+};
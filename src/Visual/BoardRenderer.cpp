@@ -2,6 +2,56 @@
 #include <SFML/Graphics.hpp>
 #include <iostream>
 
+namespace
+{
+    // 数值面板文字字号
+    constexpr unsigned LABEL_CHARACTER_SIZE = 18;
+
+    // 所有棋盘共用的字体，第一次使用时加载
+    const sf::Font *boardFont()
+    {
+        static sf::Font font;
+        static bool loaded = false;
+        static bool attempted = false;
+        if (!attempted)
+        {
+            attempted = true;
+            loaded = font.loadFromFile("C:/Windows/Fonts/arial.ttf");
+            if (!loaded)
+            {
+                std::cerr << "无法加载字体，使用默认渲染" << std::endl;
+            }
+        }
+        return loaded ? &font : nullptr;
+    }
+
+    // 以两个三角形追加一个填充矩形（纹理坐标取图集中的白色像素）
+    void appendRect(sf::VertexArray &vertices, const sf::FloatRect &rect, sf::Color color, sf::Vector2f texel)
+    {
+        sf::Vector2f topLeft(rect.left, rect.top);
+        sf::Vector2f topRight(rect.left + rect.width, rect.top);
+        sf::Vector2f bottomLeft(rect.left, rect.top + rect.height);
+        sf::Vector2f bottomRight(rect.left + rect.width, rect.top + rect.height);
+        vertices.append(sf::Vertex(topLeft, color, texel));
+        vertices.append(sf::Vertex(topRight, color, texel));
+        vertices.append(sf::Vertex(bottomRight, color, texel));
+        vertices.append(sf::Vertex(topLeft, color, texel));
+        vertices.append(sf::Vertex(bottomRight, color, texel));
+        vertices.append(sf::Vertex(bottomLeft, color, texel));
+    }
+
+    // 追加矩形外侧的边框（与sf::RectangleShape的正外框厚度一致）
+    void appendFrame(sf::VertexArray &vertices, const sf::FloatRect &rect, float thickness, sf::Color color,
+                     sf::Vector2f texel)
+    {
+        float outerWidth = rect.width + 2 * thickness;
+        appendRect(vertices, sf::FloatRect(rect.left - thickness, rect.top - thickness, outerWidth, thickness), color, texel);
+        appendRect(vertices, sf::FloatRect(rect.left - thickness, rect.top + rect.height, outerWidth, thickness), color, texel);
+        appendRect(vertices, sf::FloatRect(rect.left - thickness, rect.top, thickness, rect.height), color, texel);
+        appendRect(vertices, sf::FloatRect(rect.left + rect.width, rect.top, thickness, rect.height), color, texel);
+    }
+}
+
 BoardRenderer::BoardRenderer()
     : m_boardSize(3), m_cellSize(80.0f), m_position(0, 0), m_gValue(0), m_hValue(0), m_fValue(0), m_showValuePanel(false), m_highlightBorder(false)
 {
@@ -41,7 +91,17 @@ void BoardRenderer::setHighlightBorder(bool highlight)
 
 void BoardRenderer::draw(sf::RenderWindow &window, const PuzzleState &state) const
 {
-    // 绘制棋盘网格
+    // 单个棋盘也走批量路径：矩形和文字一次绘制
+    sf::VertexArray vertices(sf::Triangles);
+    appendBoard(vertices, state);
+    window.draw(vertices, &getTexture());
+}
+
+void BoardRenderer::appendBoard(sf::VertexArray &vertices, const PuzzleState &state) const
+{
+    ensureAtlas();
+
+    // 棋盘网格
     for (int i = 0; i < m_boardSize; ++i)
     {
         for (int j = 0; j < m_boardSize; ++j)
@@ -49,162 +109,96 @@ void BoardRenderer::draw(sf::RenderWindow &window, const PuzzleState &state) con
             int index = i * m_boardSize + j;
             if (index < state.size())
             {
-                drawCell(window, state[index], i, j);
+                appendCell(vertices, state[index], i, j);
             }
         }
     }
 
-    // 只在需要时绘制数值面板
+    // 只在需要时追加数值面板
     if (m_showValuePanel)
     {
-        drawValuePanel(window);
+        appendValuePanel(vertices);
     }
 
-    // 如果启用了高亮边框，绘制边框
+    // 如果启用了高亮边框，追加边框
     if (m_highlightBorder)
     {
-        drawHighlightBorder(window);
+        appendHighlightBorder(vertices);
+    }
+}
+
+const sf::Texture &BoardRenderer::getTexture() const
+{
+    ensureAtlas();
+    return m_atlas.getTexture();
+}
+
+void BoardRenderer::ensureAtlas() const
+{
+    // 格子数字字号随格子大小变化，只在格子大小改变后重新烘焙
+    unsigned numberSize = static_cast<unsigned int>(m_cellSize * 0.4f);
+    if (!m_atlas.isBuilt(numberSize, LABEL_CHARACTER_SIZE))
+    {
+        m_atlas.build(boardFont(), numberSize, LABEL_CHARACTER_SIZE);
     }
 }
 
-void BoardRenderer::drawCell(sf::RenderWindow &window, int value, int row, int col) const
+void BoardRenderer::appendCell(sf::VertexArray &vertices, int value, int row, int col) const
 {
     // 计算单元格位置
     float x = m_position.x + col * m_cellSize;
     float y = m_position.y + row * m_cellSize;
 
-    // 绘制单元格背景
-    sf::RectangleShape cell(sf::Vector2f(m_cellSize - 2, m_cellSize - 2));
-    cell.setPosition(x + 1, y + 1);
-
     // 根据值设置颜色：0表示空格（灰色），其他数字根据高亮状态设置颜色
+    sf::Color fill = sf::Color::White;
     if (value == 0)
     {
-        cell.setFillColor(sf::Color(200, 200, 200)); // 灰色
+        fill = sf::Color(200, 200, 200); // 灰色
     }
-    else
+    else if (m_highlightBorder)
     {
-        if (m_highlightBorder)
-        {
-            // 高亮状态下使用浅黄色背景
-            cell.setFillColor(sf::Color(255, 255, 200)); // 浅黄色
-        }
-        else
-        {
-            cell.setFillColor(sf::Color::White);
-        }
+        fill = sf::Color(255, 255, 200); // 高亮状态下使用浅黄色背景
     }
-    cell.setOutlineColor(sf::Color::Black);
-    cell.setOutlineThickness(1.0f);
 
-    window.draw(cell);
+    // 整格先铺黑色，再在内缩1像素处填充，相当于1像素的黑色外框
+    sf::Vector2f texel = m_atlas.getWhiteTexel();
+    appendRect(vertices, sf::FloatRect(x, y, m_cellSize, m_cellSize), sf::Color::Black, texel);
+    appendRect(vertices, sf::FloatRect(x + 1, y + 1, m_cellSize - 2, m_cellSize - 2), fill, texel);
 
-    // 如果不是空格，绘制数字
+    // 如果不是空格，追加数字
     if (value != 0)
     {
-        drawNumber(window, value, x + m_cellSize / 2, y + m_cellSize / 2);
+        m_atlas.appendNumber(vertices, value, sf::Vector2f(x + m_cellSize / 2, y + m_cellSize / 2), sf::Color::Black);
     }
 }
 
-void BoardRenderer::drawNumber(sf::RenderWindow &window, int number, float x, float y) const
-{
-    static sf::Font font;
-    static bool fontLoaded = false;
-
-    // 尝试加载字体
-    if (!fontLoaded)
-    {
-        if (!font.loadFromFile("C:/Windows/Fonts/arial.ttf"))
-        {
-            std::cerr << "无法加载字体，使用默认渲染" << std::endl;
-        }
-        fontLoaded = true;
-    }
-
-    sf::Text text;
-    text.setFont(font);
-    text.setString(std::to_string(number));
-    text.setCharacterSize(static_cast<unsigned int>(m_cellSize * 0.4f));
-    text.setFillColor(sf::Color::Black);
-
-    // 居中文本
-    sf::FloatRect textRect = text.getLocalBounds();
-    text.setOrigin(textRect.left + textRect.width / 2.0f,
-                   textRect.top + textRect.height / 2.0f);
-    text.setPosition(x, y);
-
-    window.draw(text);
-}
-
-void BoardRenderer::drawValuePanel(sf::RenderWindow &window) const
+void BoardRenderer::appendValuePanel(sf::VertexArray &vertices) const
 {
     float boardWidth = m_boardSize * m_cellSize;
     float panelHeight = 40.0f;                    // 面板高度
     float panelY = m_position.y + boardWidth + 5; // 面板在棋盘下方
 
-    // 绘制面板背景 - 宽度与棋盘一致
-    sf::RectangleShape background(sf::Vector2f(boardWidth, panelHeight));
-    background.setPosition(m_position.x, panelY);
-    background.setFillColor(sf::Color(50, 50, 50, 200)); // 半透明深灰色
-    background.setOutlineColor(sf::Color::White);
-    background.setOutlineThickness(1.0f);
-    window.draw(background);
+    // 面板背景宽度与棋盘一致，半透明深灰色，白色外框
+    sf::FloatRect panel(m_position.x, panelY, boardWidth, panelHeight);
+    sf::Vector2f texel = m_atlas.getWhiteTexel();
+    appendRect(vertices, panel, sf::Color(50, 50, 50, 200), texel);
+    appendFrame(vertices, panel, 1.0f, sf::Color::White, texel);
 
-    // 绘制标题
-    // drawText(window, "Status", m_position.x + 10, panelY + 10, sf::Color::Yellow);
-
-    // 绘制g值
-    drawText(window, "g: " + std::to_string(m_gValue),
-             m_position.x + 10, panelY + 10);
-
-    // 绘制h值
-    drawText(window, "h: " + std::to_string(m_hValue),
-             m_position.x + boardWidth / 3, panelY + 10);
-
-    // 绘制f值
-    drawText(window, "f: " + std::to_string(m_fValue),
-             m_position.x + 2 * boardWidth / 3, panelY + 10);
-}
-
-void BoardRenderer::drawText(sf::RenderWindow &window, const std::string &text, float x, float y, sf::Color color) const
-{
-    static sf::Font font;
-    static bool fontLoaded = false;
-
-    // 尝试加载字体
-    if (!fontLoaded)
-    {
-        if (!font.loadFromFile("C:/Windows/Fonts/arial.ttf"))
-        {
-            std::cerr << "无法加载字体" << std::endl;
-        }
-        fontLoaded = true;
-    }
-
-    sf::Text sfText;
-    sfText.setFont(font);
-    sfText.setString(text);
-    sfText.setCharacterSize(18);
-    sfText.setFillColor(color);
-    sfText.setPosition(x, y);
-
-    window.draw(sfText);
+    // g、h、f三个值，标签和数字都取自字形图集
+    m_atlas.appendValue(vertices, 'g', m_gValue, sf::Vector2f(m_position.x + 10, panelY + 10), sf::Color::White);
+    m_atlas.appendValue(vertices, 'h', m_hValue, sf::Vector2f(m_position.x + boardWidth / 3, panelY + 10), sf::Color::White);
+    m_atlas.appendValue(vertices, 'f', m_fValue, sf::Vector2f(m_position.x + 2 * boardWidth / 3, panelY + 10), sf::Color::White);
 }
 
-void BoardRenderer::drawHighlightBorder(sf::RenderWindow &window) const
+void BoardRenderer::appendHighlightBorder(sf::VertexArray &vertices) const
 {
     // 计算棋盘的总尺寸
     float boardWidth = m_boardSize * m_cellSize;
     float boardHeight = boardWidth;
-    
-    // 创建高亮边框
-    sf::RectangleShape border(sf::Vector2f(boardWidth, boardHeight));
-    border.setPosition(m_position.x, m_position.y);
-    border.setFillColor(sf::Color::Transparent);
-    border.setOutlineColor(sf::Color::Yellow); // 使用黄色高亮
-    border.setOutlineThickness(3.0f); // 较粗的边框
-    
-    window.draw(border);
+
+    // 黄色的较粗边框，画在棋盘外侧
+    appendFrame(vertices, sf::FloatRect(m_position.x, m_position.y, boardWidth, boardHeight), 3.0f, sf::Color::Yellow,
+                m_atlas.getWhiteTexel());
 }
 
 sf::Vector2f BoardRenderer::getTotalSize() const
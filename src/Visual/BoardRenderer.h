@@ -2,6 +2,7 @@
 
 #include <SFML/Graphics.hpp>
 #include "../Core/PuzzleState.h"
+#include "GlyphAtlas.h"
 
 class BoardRenderer
 {
@@ -24,6 +25,13 @@ public:
     // 绘制棋盘和数值面板
     void draw(sf::RenderWindow &window, const PuzzleState &state) const;
 
+    // 把当前位置的棋盘（单元格、数字、数值面板、高亮边框）追加到批量顶点数组（sf::Triangles）
+    // 多个棋盘追加到同一个数组后以getTexture()为纹理一次绘制
+    void appendBoard(sf::VertexArray &vertices, const PuzzleState &state) const;
+
+    // 批量顶点数组使用的纹理（字形图集，按当前格子大小烘焙）
+    const sf::Texture &getTexture() const;
+
     // 获取整体尺寸信息
     sf::Vector2f getTotalSize() const;
     sf::Vector2f getPosition() const;
@@ -38,19 +46,17 @@ private:
     int m_fValue;
     bool m_showValuePanel;   // 是否显示数值面板
     bool m_highlightBorder;  // 是否显示高亮边框
+    mutable GlyphAtlas m_atlas; // 数字和面板文字的字形图集（首次使用时烘焙）
 
-    // 绘制单个单元格
-    void drawCell(sf::RenderWindow &window, int value, int row, int col) const;
-
-    // 绘制数字
-    void drawNumber(sf::RenderWindow &window, int number, float x, float y) const;
+    // 追加单个单元格
+    void appendCell(sf::VertexArray &vertices, int value, int row, int col) const;
 
-    // 绘制数值面板
-    void drawValuePanel(sf::RenderWindow &window) const;
+    // 追加数值面板
+    void appendValuePanel(sf::VertexArray &vertices) const;
 
-    // 绘制文本
-    void drawText(sf::RenderWindow &window, const std::string &text, float x, float y, sf::Color color = sf::Color::White) const;
+    // 格子大小改变后重新烘焙字形图集
+    void ensureAtlas() const;
 
-    // 绘制高亮边框
-    void drawHighlightBorder(sf::RenderWindow &window) const;
+    // 追加高亮边框
+    void appendHighlightBorder(sf::VertexArray &vertices) const;
 };
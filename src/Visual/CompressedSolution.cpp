@@ -0,0 +1,97 @@
+#include "CompressedSolution.h"
+#include <algorithm>
+#include <iterator>
+
+CompressedSolution::CompressedSolution(const Tree &tree)
+    : m_tree(tree)
+{
+    const FlatTree &flat = tree.getFlatTree();
+    int count = static_cast<int>(flat.size());
+    m_keptParent.assign(count, FlatTree::NONE);
+    m_hidden.assign(count, 0);
+
+    // 根、叶子和分叉节点保留；恰有一个子节点的非根节点位于单链中间，被折叠
+    std::vector<char> kept(count, 0);
+    for (int index = 0; index < count; ++index)
+    {
+        if (!flat.contains(index))
+            continue;
+        int child = flat.firstChild(index);
+        bool unary = child != FlatTree::NONE && flat.nextSibling(child) == FlatTree::NONE;
+        if (flat.parent(index) == FlatTree::NONE || !unary)
+        {
+            kept[index] = 1;
+            m_kept.push_back(index);
+        }
+    }
+
+    // 被折叠的节点都只有一个子节点，从每个保留节点向上走到保留祖先，每个折叠节点只经过一次
+    for (int index : m_kept)
+    {
+        int ancestor = flat.parent(index);
+        int hidden = 0;
+        while (ancestor != FlatTree::NONE && !kept[ancestor])
+        {
+            ancestor = flat.parent(ancestor);
+            ++hidden;
+        }
+        m_keptParent[index] = ancestor;
+        m_hidden[index] = hidden;
+    }
+
+    m_compressedOf.assign(count, -1);
+    renumber();
+}
+
+bool CompressedSolution::expandChain(int index)
+{
+    int bottom = m_kept[index];
+    if (m_hidden[bottom] == 0)
+        return false;
+
+    // 链上的节点（自下而上）逐个成为保留节点，父节点就是原父节点
+    const FlatTree &flat = m_tree.getFlatTree();
+    std::vector<int> chain;
+    for (int node = flat.parent(bottom); node != m_keptParent[bottom]; node = flat.parent(node))
+    {
+        chain.push_back(node);
+        m_keptParent[node] = flat.parent(node);
+        m_hidden[node] = 0;
+    }
+    m_keptParent[bottom] = flat.parent(bottom);
+    m_hidden[bottom] = 0;
+
+    std::sort(chain.begin(), chain.end());
+    std::vector<int> merged;
+    merged.reserve(m_kept.size() + chain.size());
+    std::merge(m_kept.begin(), m_kept.end(), chain.begin(), chain.end(), std::back_inserter(merged));
+    m_kept.swap(merged);
+    renumber();
+    return true;
+}
+
+std::vector<int> CompressedSolution::getPathToRoot(int index) const
+{
+    std::vector<int> path;
+    while (index != -1)
+    {
+        path.push_back(index);
+        index = getParent(index);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+void CompressedSolution::renumber()
+{
+    int count = static_cast<int>(m_kept.size());
+    for (int i = 0; i < count; ++i)
+        m_compressedOf[m_kept[i]] = i;
+
+    m_parents.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        int parent = m_keptParent[m_kept[i]];
+        m_parents[i] = parent == FlatTree::NONE ? -1 : m_compressedOf[parent];
+    }
+}
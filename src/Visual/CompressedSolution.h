@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../Core/TreeNode.h"
+#include "../Parser/Solution.h"
+#include <vector>
+
+/**
+ * @brief 折叠单链后的树视图
+ *
+ * 保留根、叶子、分叉节点（子节点数不为1）以及已展开链上的节点，按原索引升序重新编号；
+ * 每个保留节点的父节点是最近的保留祖先，两者之间被折叠的节点数即这条边的链长。
+ * 状态和代价从原树读取，可以直接交给TreeBuilder构建，构建出的树只含保留节点，
+ * 布局和绘制的开销与分叉节点数成正比，而不是总节点数。
+ */
+class CompressedSolution : public ISolution
+{
+public:
+    /**
+     * @brief 构造函数，扫描一遍原树找出所有最长单链（O(N)）
+     * @param tree 原树（须在视图使用期间保持有效且不再增长）
+     */
+    explicit CompressedSolution(const Tree &tree);
+
+    /**
+     * @brief 展开压缩节点与其父节点之间被折叠的链，链上的节点全部成为保留节点
+     *
+     * 保留节点重新编号，耗时O(保留节点数 + 链长)
+     * @param index 链下端的压缩索引
+     * @return 该边上没有折叠节点时返回false
+     */
+    bool expandChain(int index);
+
+    /**
+     * @brief 压缩索引对应的原树索引
+     */
+    int originalIndex(int index) const { return m_kept[index]; }
+
+    /**
+     * @brief 原树索引对应的压缩索引
+     * @return 节点被折叠时返回-1
+     */
+    int compressedIndex(int originalIndex) const { return m_compressedOf[originalIndex]; }
+
+    /**
+     * @brief 压缩节点与其父节点之间折叠的节点数
+     */
+    int hiddenCount(int index) const { return m_hidden[m_kept[index]]; }
+
+    const PuzzleState &getState(int index) const override { return m_tree.getState(m_kept[index]); }
+    int getParent(int index) const override { return m_parents[index]; }
+    int getG(int index) const override { return m_tree.getG(m_kept[index]); }
+    int getH(int index) const override { return m_tree.getH(m_kept[index]); }
+    int getF(int index) const override { return m_tree.getF(m_kept[index]); }
+    size_t size() const override { return m_kept.size(); }
+    std::vector<int> getPathToRoot(int index) const override;
+
+    /**
+     * @brief 压缩视图自身的列（不含原树）
+     */
+    size_t memoryBytes() const override
+    {
+        return sizeof(*this) + vectorBytes(m_kept) + vectorBytes(m_parents) + vectorBytes(m_compressedOf) +
+               vectorBytes(m_keptParent) + vectorBytes(m_hidden);
+    }
+    ColumnSpan<int> getParentColumn() const override { return {m_parents.data(), m_parents.size()}; }
+
+private:
+    /**
+     * @brief 按保留节点列表重新编号并生成压缩后的父节点列
+     */
+    void renumber();
+
+    const Tree &m_tree;              // 原树
+    std::vector<int> m_kept;         // 保留节点的原索引（升序）
+    std::vector<int> m_parents;      // 压缩后的父节点列
+    std::vector<int> m_compressedOf; // 原索引 -> 压缩索引（被折叠的节点为-1）
+    std::vector<int> m_keptParent;   // 按原索引：最近的保留祖先
+    std::vector<int> m_hidden;       // 按原索引：与最近保留祖先之间折叠的节点数
+};
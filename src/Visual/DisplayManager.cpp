@@ -14,6 +14,14 @@ void DisplayManager::setTotalNodes(size_t totalNodes)
     reset();
 }
 
+void DisplayManager::growTotalNodes(size_t totalNodes)
+{
+    if (totalNodes > m_totalNodes)
+    {
+        m_totalNodes = totalNodes;
+    }
+}
+
 DisplayMode DisplayManager::getDisplayMode() const
 {
     return m_displayMode;
@@ -119,7 +127,8 @@ size_t DisplayManager::getTotalNodes() const
 
 bool DisplayManager::isNodeVisible(int nodeIndex) const
 {
-    return m_visibleNodes.find(nodeIndex) != m_visibleNodes.end();
+    // 节点按索引顺序显示和隐藏，可见集合总是前m_currentIndex个索引，不需要查哈希表
+    return nodeIndex >= 0 && nodeIndex < m_currentIndex;
 }
 
 void DisplayManager::setPlayInterval(sf::Time interval)
@@ -39,6 +39,12 @@ public:
      */
     void setTotalNodes(size_t totalNodes);
 
+    /**
+     * @brief 增加树节点总数但保留当前显示进度（用于流式加载）
+     * @param totalNodes 新的树节点总数，小于当前值时忽略
+     */
+    void growTotalNodes(size_t totalNodes);
+
     /**
      * @brief 获取当前显示模式
      * @return 当前显示模式
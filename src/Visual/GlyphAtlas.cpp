@@ -0,0 +1,241 @@
+#include "GlyphAtlas.h"
+#include <algorithm>
+#include <charconv>
+#include <limits>
+
+namespace
+{
+    // 图集宽度，字形按行依次排放，放不下时换行
+    constexpr unsigned ATLAS_WIDTH = 256;
+
+    // 格子数字和数值面板用到的字符
+    constexpr const char *NUMBER_CHARACTERS = "0123456789-";
+    constexpr const char *LABEL_CHARACTERS = "0123456789-ghf: ";
+
+    /**
+     * @brief 一个待拷贝进图集的字形
+     */
+    struct PendingGlyph
+    {
+        unsigned characterSize; // 字号（字体纹理按字号分页）
+        sf::IntRect source;     // 字体纹理中的范围
+        unsigned x;             // 图集中的位置（含1像素留白）
+        unsigned y;
+    };
+
+    int labelSlot(char name)
+    {
+        return name == 'g' ? 0 : name == 'h' ? 1 : 2;
+    }
+}
+
+GlyphAtlas::GlyphAtlas()
+    : m_numberSize(0), m_labelSize(0), m_numberGlyphs(), m_labelGlyphs(), m_numberRuns(), m_labelRuns()
+{
+}
+
+void GlyphAtlas::build(const sf::Font *font, unsigned numberSize, unsigned labelSize)
+{
+    m_numberSize = numberSize;
+    m_labelSize = labelSize;
+    m_numberGlyphs.fill(AtlasGlyph());
+    m_labelGlyphs.fill(AtlasGlyph());
+    m_quads.clear();
+
+    // 左上角是白色像素块，字形从它右侧开始按行排放，每个字形四周留1像素透明边避免采样串色
+    std::vector<PendingGlyph> pending;
+    unsigned x = WHITE_BLOCK + 1, y = 0, rowHeight = WHITE_BLOCK + 1;
+    auto collect = [&](std::array<AtlasGlyph, 128> &table, const char *characters, unsigned characterSize)
+    {
+        if (!font)
+            return;
+        for (const char *c = characters; *c; ++c)
+        {
+            const sf::Glyph &glyph = font->getGlyph(static_cast<sf::Uint32>(*c), characterSize, false);
+            AtlasGlyph &entry = table[static_cast<unsigned char>(*c)];
+            entry.bounds = glyph.bounds;
+            entry.advance = glyph.advance;
+            if (glyph.textureRect.width <= 0 || glyph.textureRect.height <= 0)
+                continue; // 空格只有前进量
+
+            unsigned width = glyph.textureRect.width + 2, height = glyph.textureRect.height + 2;
+            if (x + width > ATLAS_WIDTH)
+            {
+                x = 0;
+                y += rowHeight;
+                rowHeight = 0;
+            }
+            entry.textureRect = sf::FloatRect(static_cast<float>(x + 1), static_cast<float>(y + 1),
+                                              static_cast<float>(glyph.textureRect.width),
+                                              static_cast<float>(glyph.textureRect.height));
+            pending.push_back({characterSize, glyph.textureRect, x, y});
+            x += width;
+            rowHeight = std::max(rowHeight, height);
+        }
+    };
+    collect(m_numberGlyphs, NUMBER_CHARACTERS, numberSize);
+    collect(m_labelGlyphs, LABEL_CHARACTERS, labelSize);
+
+    // 透明部分取白色，字形边缘与任何顶点颜色相乘后都不会发暗
+    sf::Image image;
+    image.create(ATLAS_WIDTH, y + rowHeight, sf::Color(255, 255, 255, 0));
+    for (unsigned py = 0; py < WHITE_BLOCK; ++py)
+        for (unsigned px = 0; px < WHITE_BLOCK; ++px)
+            image.setPixel(px, py, sf::Color::White);
+
+    // 所有字形都加载后再读取字体纹理（加载字形可能使字体纹理扩大），每个字号只读取一次
+    std::vector<unsigned> sizes = {numberSize};
+    if (labelSize != numberSize)
+        sizes.push_back(labelSize);
+    for (unsigned characterSize : sizes)
+    {
+        if (!font)
+            break;
+        sf::Image page = font->getTexture(characterSize).copyToImage();
+        for (const PendingGlyph &glyph : pending)
+        {
+            if (glyph.characterSize != characterSize)
+                continue;
+            sf::IntRect source(glyph.source.left - 1, glyph.source.top - 1, glyph.source.width + 2, glyph.source.height + 2);
+            image.copy(page, glyph.x, glyph.y, source);
+        }
+    }
+    m_texture.loadFromImage(image);
+    m_texture.setSmooth(true);
+
+    // 预先排版0..99和三个标签
+    char buffer[4];
+    for (int number = 0; number < PREBAKED_NUMBERS; ++number)
+    {
+        *std::to_chars(buffer, buffer + 3, number).ptr = '\0';
+        m_numberRuns[number] = layoutRun(m_numberGlyphs, buffer, numberSize, true);
+    }
+    m_labelRuns[labelSlot('g')] = layoutRun(m_labelGlyphs, "g: ", labelSize, false);
+    m_labelRuns[labelSlot('h')] = layoutRun(m_labelGlyphs, "h: ", labelSize, false);
+    m_labelRuns[labelSlot('f')] = layoutRun(m_labelGlyphs, "f: ", labelSize, false);
+}
+
+bool GlyphAtlas::isBuilt(unsigned numberSize, unsigned labelSize) const
+{
+    return m_numberSize != 0 && m_numberSize == numberSize && m_labelSize == labelSize;
+}
+
+void GlyphAtlas::appendNumber(sf::VertexArray &vertices, int number, const sf::Vector2f &center, sf::Color color) const
+{
+    if (number >= 0 && number < PREBAKED_NUMBERS)
+    {
+        appendRun(vertices, m_numberRuns[number], center, color);
+        return;
+    }
+
+    // 更大的数字（超过10x10的棋盘）逐个字形排版，先求范围再居中
+    char buffer[16];
+    char *end = std::to_chars(buffer, buffer + sizeof(buffer), number).ptr;
+    float pen = 0, left = std::numeric_limits<float>::max(), right = std::numeric_limits<float>::lowest();
+    float top = left, bottom = right;
+    for (const char *c = buffer; c != end; ++c)
+    {
+        const AtlasGlyph &glyph = m_numberGlyphs[static_cast<unsigned char>(*c)];
+        left = std::min(left, pen + glyph.bounds.left);
+        right = std::max(right, pen + glyph.bounds.left + glyph.bounds.width);
+        top = std::min(top, m_numberSize + glyph.bounds.top);
+        bottom = std::max(bottom, m_numberSize + glyph.bounds.top + glyph.bounds.height);
+        pen += glyph.advance;
+    }
+
+    sf::Vector2f origin(center.x - (left + right) / 2.0f, center.y - (top + bottom) / 2.0f);
+    pen = 0;
+    for (const char *c = buffer; c != end; ++c)
+    {
+        const AtlasGlyph &glyph = m_numberGlyphs[static_cast<unsigned char>(*c)];
+        sf::FloatRect position(origin.x + pen + glyph.bounds.left, origin.y + m_numberSize + glyph.bounds.top,
+                               glyph.bounds.width, glyph.bounds.height);
+        appendQuad(vertices, position, glyph.textureRect, color);
+        pen += glyph.advance;
+    }
+}
+
+void GlyphAtlas::appendValue(sf::VertexArray &vertices, char name, int value, const sf::Vector2f &position,
+                             sf::Color color) const
+{
+    const TextRun &label = m_labelRuns[labelSlot(name)];
+    appendRun(vertices, label, position, color);
+
+    // 数值逐位取预烘焙的字形，不生成字符串
+    char buffer[16];
+    char *end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    float pen = position.x + label.advance;
+    for (const char *c = buffer; c != end; ++c)
+    {
+        const AtlasGlyph &glyph = m_labelGlyphs[static_cast<unsigned char>(*c)];
+        sf::FloatRect quad(pen + glyph.bounds.left, position.y + m_labelSize + glyph.bounds.top,
+                           glyph.bounds.width, glyph.bounds.height);
+        appendQuad(vertices, quad, glyph.textureRect, color);
+        pen += glyph.advance;
+    }
+}
+
+GlyphAtlas::TextRun GlyphAtlas::layoutRun(const std::array<AtlasGlyph, 128> &glyphs, const char *text,
+                                          unsigned characterSize, bool centered)
+{
+    TextRun run = {static_cast<int>(m_quads.size()), 0, 0.0f};
+    float left = std::numeric_limits<float>::max(), right = std::numeric_limits<float>::lowest();
+    float top = left, bottom = right;
+    for (const char *c = text; *c; ++c)
+    {
+        const AtlasGlyph &glyph = glyphs[static_cast<unsigned char>(*c)];
+        if (glyph.textureRect.width > 0)
+        {
+            sf::FloatRect position(run.advance + glyph.bounds.left, characterSize + glyph.bounds.top,
+                                   glyph.bounds.width, glyph.bounds.height);
+            m_quads.push_back({position, glyph.textureRect});
+            ++run.count;
+            left = std::min(left, position.left);
+            right = std::max(right, position.left + position.width);
+            top = std::min(top, position.top);
+            bottom = std::max(bottom, position.top + position.height);
+        }
+        run.advance += glyph.advance;
+    }
+
+    // 与sf::Text以局部范围中心为原点时一致
+    if (centered && run.count > 0)
+    {
+        sf::Vector2f middle((left + right) / 2.0f, (top + bottom) / 2.0f);
+        for (int i = run.first; i < run.first + run.count; ++i)
+        {
+            m_quads[i].position.left -= middle.x;
+            m_quads[i].position.top -= middle.y;
+        }
+    }
+    return run;
+}
+
+void GlyphAtlas::appendRun(sf::VertexArray &vertices, const TextRun &run, const sf::Vector2f &origin,
+                           sf::Color color) const
+{
+    for (int i = run.first; i < run.first + run.count; ++i)
+    {
+        sf::FloatRect position = m_quads[i].position;
+        position.left += origin.x;
+        position.top += origin.y;
+        appendQuad(vertices, position, m_quads[i].textureRect, color);
+    }
+}
+
+void GlyphAtlas::appendQuad(sf::VertexArray &vertices, const sf::FloatRect &position, const sf::FloatRect &textureRect,
+                            sf::Color color)
+{
+    float right = position.left + position.width, bottom = position.top + position.height;
+    float textureRight = textureRect.left + textureRect.width, textureBottom = textureRect.top + textureRect.height;
+    sf::Vertex topLeft(sf::Vector2f(position.left, position.top), color, sf::Vector2f(textureRect.left, textureRect.top));
+    sf::Vertex topRight(sf::Vector2f(right, position.top), color, sf::Vector2f(textureRight, textureRect.top));
+    sf::Vertex bottomLeft(sf::Vector2f(position.left, bottom), color, sf::Vector2f(textureRect.left, textureBottom));
+    sf::Vertex bottomRight(sf::Vector2f(right, bottom), color, sf::Vector2f(textureRight, textureBottom));
+    vertices.append(topLeft);
+    vertices.append(topRight);
+    vertices.append(bottomRight);
+    vertices.append(topLeft);
+    vertices.append(bottomRight);
+    vertices.append(bottomLeft);
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <vector>
+
+/**
+ * @brief 棋盘文字的预烘焙字形图集
+ *
+ * 按格子数字和数值面板两种字号，把用到的字形（数字、负号、"g"、"h"、"f"、冒号和空格）一次拷贝到一张纹理中，
+ * 纹理左上角另有一块白色像素，纯色矩形取这里的纹理坐标，因此矩形和文字可以放在同一个顶点数组里一次绘制。
+ * 0到99的格子数字和"g: "、"h: "、"f: "三个标签在构建时就排好版（相对位置和纹理坐标），
+ * 每帧只需复制四边形，不再创建sf::Text或拼接字符串。排版与sf::Text一致（基线在字号处，不计字距）。
+ */
+class GlyphAtlas
+{
+public:
+    /// 预先排版的格子数字个数（0..PREBAKED_NUMBERS-1）
+    static constexpr int PREBAKED_NUMBERS = 100;
+
+    GlyphAtlas();
+
+    /**
+     * @brief 烘焙图集
+     * @param font 字体（nullptr时只有白色像素块，文字不显示）
+     * @param numberSize 格子数字的字号
+     * @param labelSize 数值面板的字号
+     */
+    void build(const sf::Font *font, unsigned numberSize, unsigned labelSize);
+
+    /**
+     * @brief 是否已按给定字号烘焙
+     */
+    bool isBuilt(unsigned numberSize, unsigned labelSize) const;
+
+    /**
+     * @brief 图集纹理（绘制顶点数组时使用）
+     */
+    const sf::Texture &getTexture() const { return m_texture; }
+
+    /**
+     * @brief 白色像素块中心的纹理坐标（纯色矩形使用）
+     */
+    sf::Vector2f getWhiteTexel() const { return sf::Vector2f(WHITE_BLOCK / 2.0f, WHITE_BLOCK / 2.0f); }
+
+    /**
+     * @brief 追加以center为中心的格子数字（sf::Triangles）
+     */
+    void appendNumber(sf::VertexArray &vertices, int number, const sf::Vector2f &center, sf::Color color) const;
+
+    /**
+     * @brief 追加"名称: 数值"形式的面板文字，position为文字左上角（同sf::Text::setPosition）
+     * @param name 'g'、'h'或'f'
+     */
+    void appendValue(sf::VertexArray &vertices, char name, int value, const sf::Vector2f &position, sf::Color color) const;
+
+private:
+    static constexpr int WHITE_BLOCK = 4; // 白色像素块边长
+
+    /**
+     * @brief 图集中的一个字形
+     */
+    struct AtlasGlyph
+    {
+        sf::FloatRect bounds;      // 相对笔位置（基线）的范围
+        sf::FloatRect textureRect; // 图集中的纹理范围
+        float advance;             // 笔位置前进量
+    };
+
+    /**
+     * @brief 排好版的一个字形四边形
+     */
+    struct GlyphQuad
+    {
+        sf::FloatRect position;    // 相对排版原点的位置
+        sf::FloatRect textureRect; // 图集中的纹理范围
+    };
+
+    /**
+     * @brief 一段排好版的文字
+     */
+    struct TextRun
+    {
+        int first;     // 第一个四边形在m_quads中的位置
+        int count;     // 四边形数量
+        float advance; // 整段文字的前进量
+    };
+
+    /**
+     * @brief 按sf::Text的规则排版一段文字
+     * @param glyphs 字号对应的字形表
+     * @param text 文字（字符须已在字形表中）
+     * @param characterSize 字号（基线位置）
+     * @param centered 是否以文字范围的中心为原点（否则为左上角）
+     */
+    TextRun layoutRun(const std::array<AtlasGlyph, 128> &glyphs, const char *text, unsigned characterSize,
+                      bool centered);
+
+    /**
+     * @brief 追加一段排好版的文字
+     */
+    void appendRun(sf::VertexArray &vertices, const TextRun &run, const sf::Vector2f &origin, sf::Color color) const;
+
+    /**
+     * @brief 追加一个四边形（两个三角形）
+     */
+    static void appendQuad(sf::VertexArray &vertices, const sf::FloatRect &position, const sf::FloatRect &textureRect,
+                           sf::Color color);
+
+    sf::Texture m_texture;                              // 图集纹理
+    unsigned m_numberSize;                              // 格子数字字号（0表示尚未烘焙）
+    unsigned m_labelSize;                               // 数值面板字号
+    std::array<AtlasGlyph, 128> m_numberGlyphs;         // 格子数字字号的字形表
+    std::array<AtlasGlyph, 128> m_labelGlyphs;          // 数值面板字号的字形表
+    std::vector<GlyphQuad> m_quads;                     // 所有预排版文字的四边形
+    std::array<TextRun, PREBAKED_NUMBERS> m_numberRuns; // 0..99的格子数字
+    std::array<TextRun, 3> m_labelRuns;                 // "g: "、"h: "、"f: "
+};
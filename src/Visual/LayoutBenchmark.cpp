@@ -0,0 +1,171 @@
+#include "LayoutBenchmark.h"
+#include "TreeBuilder.h"
+#include "TreeLayout.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief 只有父节点列的合成解决方案，状态和代价都为空值
+     */
+    class SyntheticSolution : public ISolution
+    {
+    public:
+        explicit SyntheticSolution(std::vector<int> parents) : m_parents(std::move(parents)) {}
+
+        const PuzzleState &getState(int) const override { return m_state; }
+        int getParent(int index) const override { return m_parents[index]; }
+        int getG(int) const override { return 0; }
+        int getH(int) const override { return 0; }
+        int getF(int) const override { return 0; }
+        size_t size() const override { return m_parents.size(); }
+        std::vector<int> getPathToRoot(int) const override { return {}; }
+        ColumnSpan<int> getParentColumn() const override { return {m_parents.data(), m_parents.size()}; }
+        size_t memoryBytes() const override { return sizeof(*this) + vectorBytes(m_parents); }
+
+    private:
+        std::vector<int> m_parents; // 父节点列
+        PuzzleState m_state;        // 所有节点共用的空状态
+    };
+
+    std::vector<int> makeParents(const std::string &shape, size_t count, std::mt19937 &random)
+    {
+        std::vector<int> parents(count);
+        parents[0] = -1;
+        for (size_t i = 1; i < count; ++i)
+        {
+            if (shape == "random")
+                parents[i] = static_cast<int>(random() % i);
+            else if (shape == "chain")
+                parents[i] = static_cast<int>(i - 1);
+            else
+                parents[i] = static_cast<int>((i - 1) / 2);
+        }
+        return parents;
+    }
+
+    /// 原来的O(N²)建树只在节点数不超过该值时运行
+    constexpr size_t OLD_BUILDER_MAX_NODES = 10000;
+
+    /**
+     * @brief 原来的建树方式：显式栈深度优先，每创建一个节点扫描全部记录找它的子节点
+     */
+    std::unique_ptr<Tree> buildByScanning(const ISolution &solution)
+    {
+        auto tree = std::make_unique<Tree>(&solution, solution.size());
+        int rootIndex = 0;
+        for (size_t i = 0; i < solution.size(); ++i)
+        {
+            if (solution.getParent(i) == -1)
+            {
+                rootIndex = static_cast<int>(i);
+                break;
+            }
+        }
+
+        std::vector<std::pair<int, TreeNode *>> stack{{rootIndex, nullptr}};
+        while (!stack.empty())
+        {
+            auto [nodeIndex, parent] = stack.back();
+            stack.pop_back();
+            if (tree->getNodeByIndex(nodeIndex))
+                continue;
+
+            TreeNode *node = tree->createNode(nodeIndex, parent);
+            if (!parent)
+                tree->setRoot(node);
+
+            std::vector<int> children;
+            for (size_t i = 0; i < solution.size(); ++i)
+            {
+                if (solution.getParent(i) == nodeIndex)
+                    children.push_back(static_cast<int>(i));
+            }
+            for (auto it = children.rbegin(); it != children.rend(); ++it)
+                stack.emplace_back(*it, node);
+        }
+        return tree;
+    }
+
+    bool sameTree(const Tree &a, const Tree &b)
+    {
+        const FlatTree &flatA = a.getFlatTree();
+        const FlatTree &flatB = b.getFlatTree();
+        if (a.size() != b.size() || flatA.size() != flatB.size() || a.getMaxDepth() != b.getMaxDepth())
+            return false;
+        for (size_t i = 0; i < flatA.size(); ++i)
+        {
+            int index = static_cast<int>(i);
+            if (flatA.contains(index) != flatB.contains(index) ||
+                (flatA.contains(index) && flatA.parent(index) != flatB.parent(index)))
+                return false;
+        }
+        return true;
+    }
+
+    double elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+void runLayoutBenchmark(size_t maxNodes)
+{
+    std::mt19937 random(1);
+    std::vector<unsigned> threadCounts{1};
+    if (std::thread::hardware_concurrency() > 1)
+        threadCounts.push_back(std::thread::hardware_concurrency());
+
+    std::cout << std::left << std::setw(8) << "shape" << std::right << std::setw(12) << "nodes"
+              << std::setw(12) << "build ms" << std::setw(14) << "old build ms" << std::setw(9) << "threads"
+              << std::setw(14) << "layout ms" << std::setw(12) << "ns/node" << std::endl;
+
+    for (const char *shape : {"random", "chain", "binary"})
+    {
+        for (size_t count = 10000; count <= maxNodes; count *= 10)
+        {
+            SyntheticSolution solution(makeParents(shape, count, random));
+            TreeBuilder builder;
+            auto start = std::chrono::steady_clock::now();
+            std::unique_ptr<Tree> tree = builder.buildTree(solution);
+            double buildMs = elapsedMs(start);
+
+            // 原来的建树方式是O(N²)，只在小规模上对比并确认建出的树相同
+            std::string oldBuild = "-";
+            if (count <= OLD_BUILDER_MAX_NODES)
+            {
+                start = std::chrono::steady_clock::now();
+                std::unique_ptr<Tree> scanned = buildByScanning(solution);
+                std::ostringstream oss;
+                oss << std::fixed << std::setprecision(1) << elapsedMs(start);
+                oldBuild = oss.str();
+                if (!sameTree(*tree, *scanned))
+                    throw std::runtime_error(std::string("Build benchmark: builders disagree on ") + shape + " tree");
+            }
+
+            for (unsigned threadCount : threadCounts)
+            {
+                TreeLayout layout;
+                layout.setThreadCount(threadCount);
+                layout.setTree(tree.get());
+                start = std::chrono::steady_clock::now();
+                layout.calculateLayout();
+                double milliseconds = elapsedMs(start);
+
+                std::cout << std::left << std::setw(8) << shape << std::right << std::setw(12) << count
+                          << std::setw(12) << std::fixed << std::setprecision(1) << buildMs << std::setw(14) << oldBuild
+                          << std::setw(9) << threadCount << std::setw(14) << milliseconds
+                          << std::setw(12) << milliseconds * 1e6 / count << std::endl;
+            }
+        }
+    }
+}
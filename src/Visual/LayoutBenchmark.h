@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief 建树与树布局基准测试
+ *
+ * 用随机递归树、单链和完全二叉树三种合成树，从1万个节点开始每次扩大10倍直到maxNodes，
+ * 输出每种规模的TreeBuilder建树耗时、布局耗时和每节点布局耗时，用于确认两者都随节点数线性增长。
+ * 建树同时与原来每个节点扫描全部记录找子节点的O(N²)方式对比（只在1万个节点时运行，并确认两者建出的树相同）；
+ * 布局在多核机器上同时给出单线程和全部硬件线程的结果。
+ * 命令行用法：--bench-layout [maxNodes]
+ * @param maxNodes 最大节点数
+ */
+void runLayoutBenchmark(size_t maxNodes);
@@ -3,9 +3,13 @@
 #include <sstream>
 #include <iostream>
 #include <cmath>
+#include <filesystem>
 #include "../Parser/SolutionLoader.h"
+#include "../Parser/BinarySolution.h"
+#include "../Parser/StreamingSolution.h"
 #include "../Parser/ProblemLoader.h"
 #include "../Visual/TreeVisualizationManager.h"
+#include "../Visual/TreeCache.h"
 #include "../Visual/AnimationVisualizationManager.h"
 
 ProblemEditor::ProblemEditor(const sf::Vector2f& windowSize)
@@ -129,11 +133,33 @@ void ProblemEditor::initializeCommands()
         std::make_unique<FunctionCommand>([this]() { moveEmptyTile(-1, 0); }));
     m_interactionManager.registerKeyCommand(sf::Keyboard::Right, 
         std::make_unique<FunctionCommand>([this]() { moveEmptyTile(1, 0); }));
+    
+    // F键：以跟随模式打开树形视图，实时显示外部求解器追加的记录
+    m_interactionManager.registerKeyCommand(sf::Keyboard::F, 
+        std::make_unique<FunctionCommand>([this]() {
+            std::cout << "Switching to Tree View (follow mode)" << std::endl;
+            // 与Tree View按钮一样先保存当前问题
+            saveCurrentProblem();
+            m_nextMode = 3;
+        }));
+
+    // G键：以合并重复状态后的DAG形式打开树形视图
+    m_interactionManager.registerKeyCommand(sf::Keyboard::G, 
+        std::make_unique<FunctionCommand>([this]() {
+            std::cout << "Switching to Tree View (merged DAG)" << std::endl;
+            // 与Tree View按钮一样先保存当前问题
+            saveCurrentProblem();
+            m_nextMode = 4;
+        }));
 }
 
 bool ProblemEditor::handleEvent(const sf::Event& event)
 {
     m_interactionManager.handleEvent(event);
+    if (m_nextMode == 3 || m_nextMode == 4)
+    {
+        return true;
+    }
     
     if (event.type == sf::Event::MouseButtonPressed)
     {
@@ -259,7 +285,7 @@ void ProblemEditor::draw(sf::RenderTarget& target) const
         target.draw(instruction);
         
         // 绘制控制说明 - 居中显示
-        sf::Text controls("Use Arrow Keys to move empty tile | R: Reset | I/D: Change board size", m_font, 16);
+        sf::Text controls("Use Arrow Keys to move empty tile | R: Reset | I/D: Change board size | F: Follow solver | G: Merged DAG", m_font, 16);
         controls.setFillColor(sf::Color::Cyan);
         
         // 计算控制说明边界并居中
@@ -299,6 +325,16 @@ void ProblemEditor::run(sf::RenderWindow& window)
                     runAnimationView(window);
                     m_nextMode = 0; // 重置模式
                 }
+                else if (m_nextMode == 3)
+                {
+                    runTreeView(window, true);
+                    m_nextMode = 0; // 重置模式
+                }
+                else if (m_nextMode == 4)
+                {
+                    runTreeView(window, false, true);
+                    m_nextMode = 0; // 重置模式
+                }
             }
         }
         
@@ -319,17 +355,15 @@ void ProblemEditor::saveCurrentProblem()
         problemStream << m_boardSize << " ";
         
         // 添加起始状态
-        auto startValues = m_startState.getValues();
-        for (int value : startValues)
+        for (int i = 0; i < m_startState.size(); i++)
         {
-            problemStream << value << " ";
+            problemStream << m_startState[i] << " ";
         }
         
         // 添加目标状态
-        auto goalValues = m_goalState.getValues();
-        for (int value : goalValues)
+        for (int i = 0; i < m_goalState.size(); i++)
         {
-            problemStream << value << " ";
+            problemStream << m_goalState[i] << " ";
         }
         
         std::string problemLine = problemStream.str();
@@ -365,17 +399,15 @@ void ProblemEditor::saveProblemToJavaProject()
         problemStream << " "  << m_boardSize << " ";
         
         // 添加起始状态
-        auto startValues = m_startState.getValues();
-        for (int value : startValues)
+        for (int i = 0; i < m_startState.size(); i++)
         {
-            problemStream << value << " ";
+            problemStream << m_startState[i] << " ";
         }
         
         // 添加目标状态
-        auto goalValues = m_goalState.getValues();
-        for (int value : goalValues)
+        for (int i = 0; i < m_goalState.size(); i++)
         {
-            problemStream << value << " ";
+            problemStream << m_goalState[i] << " ";
         }
         
         std::string problemLine = problemStream.str();
@@ -476,13 +508,12 @@ void ProblemEditor::decreaseBoardSize()
 
 void ProblemEditor::moveEmptyTile(int dx, int dy)
 {
-    auto values = m_startState.getValues();
     int emptyIndex = -1;
     
     // 找到空白格的位置（值为0的格子）
-    for (int i = 0; i < values.size(); i++)
+    for (int i = 0; i < m_startState.size(); i++)
     {
-        if (values[i] == 0)
+        if (m_startState[i] == 0)
         {
             emptyIndex = i;
             break;
@@ -504,9 +535,8 @@ void ProblemEditor::moveEmptyTile(int dx, int dy)
             int targetIndex = targetRow * m_boardSize + targetCol;
             
             // 交换空白格和目标位置的数字
-            std::vector<int> newValues = values;
-            std::swap(newValues[emptyIndex], newValues[targetIndex]);
-            m_startState = PuzzleState(newValues);
+            m_startState.setValue(emptyIndex, m_startState[targetIndex]);
+            m_startState.setValue(targetIndex, 0);
             
         std::cout << "Moved empty tile from (" << emptyRow << "," << emptyCol 
                       << ") to (" << targetRow << "," << targetCol << ")" << std::endl;
@@ -533,15 +563,78 @@ PuzzleState ProblemEditor::createGoalState(int size)
     return PuzzleState(goalTiles);
 }
 
-void ProblemEditor::runTreeView(sf::RenderWindow& window)
+void ProblemEditor::runTreeView(sf::RenderWindow& window, bool follow, bool dag)
 {
     try
     {
-        std::cout << "Loading tree solution from data/solution.txt" << std::endl;
-        auto solution = loadSolutionTree("solution.txt");
+        if (follow)
+        {
+            // 跟随模式只读取求解器新追加的字节，树和布局随之增量增长
+            auto solution = followSolutionTree("solution.txt");
+            TreeVisualizationManager treeManager(window, sf::Vector2f(1600, 1000));
+            treeManager.run(*solution);
+            return;
+        }
+        
+        // 存在不早于solution.txt的二进制版本时直接映射solution.npsb
+        std::string solutionPath = "solution.txt";
+        std::error_code ec;
+        if (std::filesystem::exists("solution.npsb", ec) &&
+            (!std::filesystem::exists(solutionPath, ec) ||
+             std::filesystem::last_write_time("solution.npsb", ec) >= std::filesystem::last_write_time(solutionPath, ec)))
+        {
+            solutionPath = "solution.npsb";
+        }
+
+        // 文件未变化时直接复用本次会话中已加载的解决方案、树和布局
+        std::string variant = dag ? "dag" : "tree";
+        std::shared_ptr<SessionEntry> entry = m_sessionCache.find(solutionPath, variant);
+        if (entry)
+        {
+            std::cout << "Session cache hit for " << solutionPath << " (" << variant << ")" << std::endl;
+        }
+        else
+        {
+            entry = loadTreeSession(solutionPath, variant, dag);
+        }
         
         TreeVisualizationManager treeManager(window, sf::Vector2f(1600, 1000));
-        treeManager.run(*solution);
+        treeManager.setDagMode(dag);
+        treeManager.setCacheKey(entry->sourceKey);
+        if (entry->tree)
+        {
+            treeManager.setPrebuiltTree(entry->tree, entry->layout);
+        }
+        treeManager.run(*entry->solution);
+        
+        // 截断或损坏的文件只加载了出错前的记录，不能缓存，下次打开时重新加载并报告错误
+        if (entry->solution->hasFailed())
+        {
+            m_sessionCache.erase(solutionPath, variant);
+            return;
+        }
+        
+        // 记录全部到达后保留树和布局，下次切换回来时不再构建
+        if (!entry->tree)
+        {
+            entry->tree = treeManager.getCompleteTree();
+            entry->layout = treeManager.getCompleteLayout();
+        }
+        
+        // 文本解决方案完整加载后转换为.npsb缓存，下次启动时直接映射
+        if (!entry->persisted && entry->solution->isComplete())
+        {
+            try
+            {
+                TreeCache::storeSolution(*entry->solution, entry->sourceKey);
+                entry->persisted = true;
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "Cannot store solution cache: " << e.what() << std::endl;
+            }
+        }
+        m_sessionCache.trim();
     }
     catch (const std::exception& e)
     {
@@ -558,15 +651,55 @@ void ProblemEditor::runTreeView(sf::RenderWindow& window)
     }
 }
 
+std::shared_ptr<SessionEntry> ProblemEditor::loadTreeSession(const std::string& solutionPath,
+                                                             const std::string& variant, bool dag)
+{
+    // 树视图和DAG视图可以共用同一份已完整加载的解决方案
+    std::shared_ptr<SessionEntry> sibling = m_sessionCache.find(solutionPath, dag ? "tree" : "dag");
+    if (sibling && sibling->solution->isComplete() && !sibling->solution->hasFailed())
+    {
+        std::shared_ptr<SessionEntry> entry = m_sessionCache.insert(solutionPath, variant, sibling->solution);
+        entry->sourceKey = sibling->sourceKey;
+        entry->persisted = sibling->persisted;
+        return entry;
+    }
+
+    // 按路径、大小和修改时间查找磁盘缓存：同一份文本解决方案已转换过时直接映射缓存的.npsb，不再解析。
+    // 只读取文件元数据，不在界面线程上扫描文件内容
+    uint64_t sourceKey = TreeCache::fileKey(solutionPath);
+    bool textSource = !isBinarySolutionFile(solutionPath);
+    std::unique_ptr<ISolution> solution = textSource ? TreeCache::openSolution(sourceKey) : nullptr;
+    bool persisted = !textSource || solution != nullptr;
+
+    // 二进制文件映射即可用；文本文件在后台流式解析，树视图随记录到达逐步增长。
+    // DAG视图需要全部记录才能确定重复状态，因此一次加载完整
+    if (!solution)
+    {
+        std::cout << "Loading tree solution from " << solutionPath << std::endl;
+        solution = dag || !textSource ? loadSolutionTree(solutionPath)
+                                      : loadSolutionTreeStreaming(solutionPath);
+    }
+
+    std::shared_ptr<SessionEntry> entry = m_sessionCache.insert(solutionPath, variant, std::move(solution));
+    entry->sourceKey = sourceKey;
+    entry->persisted = persisted;
+    return entry;
+}
+
 void ProblemEditor::runAnimationView(sf::RenderWindow& window)
 {
     try
     {
-        std::cout << "Loading animation solution from ./solutionAnimation.txt" << std::endl;
-        auto solution = loadSolutionAnimation("./solutionAnimation.txt");
+        const std::string animationPath = "./solutionAnimation.txt";
+        std::shared_ptr<SessionEntry> entry = m_sessionCache.find(animationPath, "animation");
+        if (!entry)
+        {
+            std::cout << "Loading animation solution from " << animationPath << std::endl;
+            entry = m_sessionCache.insert(animationPath, "animation", loadSolutionAnimation(animationPath));
+        }
         
         AnimationVisualizationManager animationManager(window, sf::Vector2f(1600, 1000));
-        animationManager.run(*solution);
+        animationManager.run(*entry->solution);
     }
     catch (const std::exception& e)
     {
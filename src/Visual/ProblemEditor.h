@@ -6,6 +6,7 @@
 #include "../Core/PuzzleState.h"
 #include "../Visual/BoardRenderer.h"
 #include "../Interaction/InteractionManager.h"
+#include "../Visual/SessionCache.h"
 
 /**
  * @brief 问题编辑器类
@@ -123,8 +124,20 @@ private:
 
     /**
      * @brief 运行树形视图
+     * @param window SFML窗口
+     * @param follow 是否跟随外部求解器持续追加的solution.txt
+     * @param dag 是否合并重复状态，以DAG形式显示
+     */
+    void runTreeView(sf::RenderWindow& window, bool follow = false, bool dag = false);
+
+    /**
+     * @brief 加载树视图使用的解决方案并加入会话缓存
+     * @param solutionPath 解决方案文件路径
+     * @param variant 会话缓存中的用途（"tree"或"dag"）
+     * @param dag 是否为DAG视图（需要一次加载完整）
+     * @return 新的会话缓存条目
      */
-    void runTreeView(sf::RenderWindow& window);
+    std::shared_ptr<SessionEntry> loadTreeSession(const std::string& solutionPath, const std::string& variant, bool dag);
 
     /**
      * @brief 运行动画视图
@@ -159,5 +172,6 @@ private:
     // 选中状态
     int m_selectedCell;                     // 当前选中的单元格索引
     bool m_shouldExit;                      // 是否应该退出编辑器
-    int m_nextMode;                         // 下一个模式：0=编辑器，1=树形视图，2=动画视图
+    SessionCache m_sessionCache;            // 已加载的解决方案、树和布局（视图切换之间复用）
+    int m_nextMode;                         // 下一个模式：0=编辑器，1=树形视图，2=动画视图，3=跟随模式树形视图，4=DAG树形视图
 };
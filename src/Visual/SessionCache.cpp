@@ -0,0 +1,110 @@
+#include "SessionCache.h"
+#include "TreeLayout.h"
+#include <algorithm>
+#include <iostream>
+
+size_t SessionEntry::memoryBytes() const
+{
+    size_t bytes = 0;
+    if (solution)
+    {
+        // 各解决方案按自己的存储方式统计（完整状态列、差分编码、映射的文件等）
+        bytes += solution->memoryBytes();
+    }
+    if (tree)
+    {
+        // 节点本身（子节点链接在节点内）、节点指针表、FlatTree的6列
+        bytes += tree->size() * (sizeof(TreeNode) + sizeof(TreeNode *) + 6 * sizeof(int));
+    }
+    if (layout)
+    {
+        // 位置列和布局算法的7个工作列
+        bytes += layout->getAllNodePositions().size() * (sizeof(sf::Vector2f) + 7 * sizeof(float));
+    }
+    return bytes;
+}
+
+SessionCache::SessionCache(size_t budgetBytes)
+    : m_budget(budgetBytes), m_useCounter(0)
+{
+}
+
+std::shared_ptr<SessionEntry> SessionCache::find(const std::string &path, const std::string &variant)
+{
+    auto it = std::find_if(m_slots.begin(), m_slots.end(), [&](const Slot &slot)
+                           { return slot.path == path && slot.variant == variant; });
+    if (it == m_slots.end())
+    {
+        return nullptr;
+    }
+
+    // 文件在上次加载后被修改（或删除）时丢弃旧条目
+    std::error_code timeError, sizeError;
+    auto writeTime = std::filesystem::last_write_time(path, timeError);
+    auto fileSize = std::filesystem::file_size(path, sizeError);
+    if (timeError || sizeError || writeTime != it->writeTime || fileSize != it->fileSize)
+    {
+        std::cout << "Session cache: " << path << " changed on disk, reloading" << std::endl;
+        m_slots.erase(it);
+        return nullptr;
+    }
+
+    // 截断或损坏的文件只加载了出错前的记录，重新加载以报告错误
+    if (it->entry->solution->hasFailed())
+    {
+        m_slots.erase(it);
+        return nullptr;
+    }
+
+    it->lastUse = ++m_useCounter;
+    return it->entry;
+}
+
+void SessionCache::erase(const std::string &path, const std::string &variant)
+{
+    m_slots.erase(std::remove_if(m_slots.begin(), m_slots.end(), [&](const Slot &slot)
+                                 { return slot.path == path && slot.variant == variant; }),
+                  m_slots.end());
+}
+
+std::shared_ptr<SessionEntry> SessionCache::insert(const std::string &path, const std::string &variant,
+                                                   std::shared_ptr<ISolution> solution)
+{
+    erase(path, variant);
+
+    std::error_code ec;
+    Slot slot;
+    slot.path = path;
+    slot.variant = variant;
+    slot.writeTime = std::filesystem::last_write_time(path, ec);
+    slot.fileSize = std::filesystem::file_size(path, ec);
+    slot.lastUse = ++m_useCounter;
+    slot.entry = std::make_shared<SessionEntry>();
+    slot.entry->solution = std::move(solution);
+    m_slots.push_back(slot);
+
+    trim();
+    return slot.entry;
+}
+
+void SessionCache::trim()
+{
+    // 最近使用的条目总是保留，即使它单独超出预算
+    while (m_slots.size() > 1 && memoryUsage() > m_budget)
+    {
+        auto oldest = std::min_element(m_slots.begin(), m_slots.end(), [](const Slot &a, const Slot &b)
+                                       { return a.lastUse < b.lastUse; });
+        std::cout << "Session cache: evicting " << oldest->path << " (" << oldest->variant << ")" << std::endl;
+        m_slots.erase(oldest);
+    }
+}
+
+size_t SessionCache::memoryUsage() const
+{
+    size_t bytes = 0;
+    for (const Slot &slot : m_slots)
+    {
+        bytes += slot.entry->memoryBytes();
+    }
+    return bytes;
+}
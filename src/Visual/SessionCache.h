@@ -0,0 +1,100 @@
+#pragma once
+
+#include "../Core/TreeNode.h"
+#include "../Parser/Solution.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TreeLayout;
+
+/**
+ * @brief 会话缓存中的一项：已加载的解决方案及由它构建的树和布局
+ */
+struct SessionEntry
+{
+    std::shared_ptr<ISolution> solution; ///< 已加载的解决方案（流式加载时可能仍在增长）
+    std::shared_ptr<Tree> tree;          ///< 完整构建的树（记录未全部到达时为空）
+    std::shared_ptr<TreeLayout> layout;  ///< 与tree对应的布局
+    uint64_t sourceKey = 0;              ///< 文件键（TreeCache::fileKey）
+    bool persisted = false;              ///< 解决方案已在磁盘缓存中（或本身就是二进制文件）
+
+    /**
+     * @brief 估计占用的内存字节数（解决方案自身报告的占用、树节点及拓扑列、布局位置）
+     */
+    size_t memoryBytes() const;
+};
+
+/**
+ * @brief 编辑器会话内的解决方案缓存
+ *
+ * 按文件路径和用途（树、DAG、动画）保存已加载的解决方案、树和布局，
+ * 条目同时记录加载时文件的修改时间和大小，查找时两者与磁盘上一致才算命中，否则丢弃旧条目；
+ * 加载出错（ISolution::hasFailed）的条目同样丢弃，下次重新加载。
+ * 总内存超过预算时按最近最少使用的顺序淘汰，最近使用的条目总是保留。
+ */
+class SessionCache
+{
+public:
+    /// 默认内存预算（1GB）
+    static constexpr size_t DEFAULT_BUDGET = size_t(1) << 30;
+
+    /**
+     * @brief 构造函数
+     * @param budgetBytes 内存预算（字节）
+     */
+    explicit SessionCache(size_t budgetBytes = DEFAULT_BUDGET);
+
+    /**
+     * @brief 查找与磁盘上文件一致的条目
+     * @param path 文件路径
+     * @param variant 用途（"tree"、"dag"、"animation"）
+     * @return 命中返回条目，否则返回nullptr（文件已变化或加载出错的旧条目同时被丢弃）
+     */
+    std::shared_ptr<SessionEntry> find(const std::string &path, const std::string &variant);
+
+    /**
+     * @brief 丢弃条目（如加载出错的解决方案）
+     * @param path 文件路径
+     * @param variant 用途
+     */
+    void erase(const std::string &path, const std::string &variant);
+
+    /**
+     * @brief 新建条目，记录文件当前的修改时间和大小
+     * @param path 文件路径
+     * @param variant 用途
+     * @param solution 已加载的解决方案
+     * @return 新条目（之后构建的树和布局直接写入该条目）
+     */
+    std::shared_ptr<SessionEntry> insert(const std::string &path, const std::string &variant,
+                                         std::shared_ptr<ISolution> solution);
+
+    /**
+     * @brief 按内存预算淘汰最久未使用的条目（条目内容增长后调用）
+     */
+    void trim();
+
+    /**
+     * @brief 当前所有条目估计占用的内存字节数
+     */
+    size_t memoryUsage() const;
+
+private:
+    struct Slot
+    {
+        std::string path;                          // 文件路径
+        std::string variant;                       // 用途
+        std::filesystem::file_time_type writeTime; // 加载时的修改时间
+        uintmax_t fileSize;                        // 加载时的文件大小
+        uint64_t lastUse;                          // 最近一次使用的序号
+        std::shared_ptr<SessionEntry> entry;       // 缓存内容
+    };
+
+    std::vector<Slot> m_slots; // 所有条目（数量很少，线性查找）
+    size_t m_budget;           // 内存预算
+    uint64_t m_useCounter;     // 使用序号计数
+};
@@ -0,0 +1,180 @@
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    // 闭区间相交判断（sf::FloatRect::intersects要求重叠面积大于0，宽或高为0的竖直、水平线段会被漏掉）
+    bool overlaps(const sf::FloatRect &a, const sf::FloatRect &b)
+    {
+        return a.left <= b.left + b.width && b.left <= a.left + a.width &&
+               a.top <= b.top + b.height && b.top <= a.top + a.height;
+    }
+}
+
+SpatialIndex::SpatialIndex()
+    : m_origin(0, 0), m_cellSize(1.0f), m_columns(0), m_rows(0), m_built(false)
+{
+}
+
+void SpatialIndex::clear()
+{
+    m_ids.clear();
+    m_boxes.clear();
+    m_removed.clear();
+    m_cellStart.clear();
+    m_cellItems.clear();
+    m_largeItems.clear();
+    m_dynamicItems.clear();
+    m_columns = 0;
+    m_rows = 0;
+    m_built = false;
+}
+
+int SpatialIndex::insert(int id, const sf::FloatRect &box)
+{
+    int item = static_cast<int>(m_ids.size());
+    m_ids.push_back(id);
+    m_boxes.push_back(box);
+    m_removed.push_back(0);
+    if (m_built)
+        m_dynamicItems.push_back(item);
+    return item;
+}
+
+void SpatialIndex::remove(int item)
+{
+    m_removed[item] = 1;
+}
+
+void SpatialIndex::build(float cellSize)
+{
+    m_cellStart.clear();
+    m_cellItems.clear();
+    m_largeItems.clear();
+    m_dynamicItems.clear();
+    m_columns = 0;
+    m_rows = 0;
+    m_built = true;
+    if (m_boxes.empty())
+        return;
+
+    float left = std::numeric_limits<float>::max();
+    float top = std::numeric_limits<float>::max();
+    float right = std::numeric_limits<float>::lowest();
+    float bottom = std::numeric_limits<float>::lowest();
+    for (const sf::FloatRect &box : m_boxes)
+    {
+        left = std::min(left, box.left);
+        top = std::min(top, box.top);
+        right = std::max(right, box.left + box.width);
+        bottom = std::max(bottom, box.top + box.height);
+    }
+    m_origin = sf::Vector2f(left, top);
+
+    // 格子数限制在条目数的两倍以内，树很宽又很深时放大格子，避免网格本身占满内存
+    double width = std::max(1.0f, right - left);
+    double height = std::max(1.0f, bottom - top);
+    double maxCells = 2.0 * m_boxes.size() + 64;
+    double size = std::max(1.0f, cellSize);
+    if ((std::floor(width / size) + 1) * (std::floor(height / size) + 1) > maxCells)
+        size = std::max(size, std::sqrt(width * height / maxCells));
+    while ((std::floor(width / size) + 1) * (std::floor(height / size) + 1) > maxCells)
+        size *= 1.25;
+    m_cellSize = static_cast<float>(size);
+    m_columns = static_cast<int>(width / size) + 1;
+    m_rows = static_cast<int>(height / size) + 1;
+
+    // 第一遍统计每个格子的条目数，第二遍按前缀和填入（计数排序）
+    int itemCount = static_cast<int>(m_boxes.size());
+    m_cellStart.assign(static_cast<size_t>(m_columns) * m_rows + 1, 0);
+    std::vector<char> skipped(itemCount, 0); // 不分桶的条目（已移除或跨越格子过多）
+    for (int item = 0; item < itemCount; ++item)
+    {
+        if (m_removed[item])
+        {
+            skipped[item] = 1;
+            continue;
+        }
+        const sf::FloatRect &box = m_boxes[item];
+        int c0 = cellColumn(box.left), c1 = cellColumn(box.left + box.width);
+        int r0 = cellRow(box.top), r1 = cellRow(box.top + box.height);
+        if ((c1 - c0 + 1) * (r1 - r0 + 1) > MAX_ITEM_CELLS)
+        {
+            skipped[item] = 1;
+            m_largeItems.push_back(item);
+            continue;
+        }
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c)
+                ++m_cellStart[static_cast<size_t>(r) * m_columns + c + 1];
+    }
+    for (size_t cell = 1; cell < m_cellStart.size(); ++cell)
+        m_cellStart[cell] += m_cellStart[cell - 1];
+
+    m_cellItems.resize(m_cellStart.back());
+    std::vector<int> fill(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (int item = 0; item < itemCount; ++item)
+    {
+        if (skipped[item])
+            continue;
+        const sf::FloatRect &box = m_boxes[item];
+        int c0 = cellColumn(box.left), c1 = cellColumn(box.left + box.width);
+        int r0 = cellRow(box.top), r1 = cellRow(box.top + box.height);
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c)
+                m_cellItems[fill[static_cast<size_t>(r) * m_columns + c]++] = item;
+    }
+}
+
+void SpatialIndex::query(const sf::FloatRect &area, std::vector<int> &result) const
+{
+    result.clear();
+
+    for (const std::vector<int> *items : {&m_largeItems, &m_dynamicItems})
+    {
+        for (int item : *items)
+        {
+            if (!m_removed[item] && overlaps(m_boxes[item], area))
+                result.push_back(m_ids[item]);
+        }
+    }
+
+    sf::FloatRect grid(m_origin.x, m_origin.y, m_columns * m_cellSize, m_rows * m_cellSize);
+    if (m_columns == 0 || !overlaps(grid, area))
+        return;
+
+    int c0 = cellColumn(area.left), c1 = cellColumn(area.left + area.width);
+    int r0 = cellRow(area.top), r1 = cellRow(area.top + area.height);
+    for (int r = r0; r <= r1; ++r)
+    {
+        for (int c = c0; c <= c1; ++c)
+        {
+            size_t cell = static_cast<size_t>(r) * m_columns + c;
+            for (int k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k)
+            {
+                int item = m_cellItems[k];
+                const sf::FloatRect &box = m_boxes[item];
+                if (m_removed[item] || !overlaps(box, area))
+                    continue;
+
+                // 条目只在它与查询范围重叠部分左上角的格子中报告
+                if (std::max(cellColumn(box.left), c0) == c && std::max(cellRow(box.top), r0) == r)
+                    result.push_back(m_ids[item]);
+            }
+        }
+    }
+}
+
+int SpatialIndex::cellColumn(float x) const
+{
+    float column = (x - m_origin.x) / m_cellSize;
+    return static_cast<int>(std::clamp(column, 0.0f, static_cast<float>(m_columns - 1)));
+}
+
+int SpatialIndex::cellRow(float y) const
+{
+    float row = (y - m_origin.y) / m_cellSize;
+    return static_cast<int>(std::clamp(row, 0.0f, static_cast<float>(m_rows - 1)));
+}
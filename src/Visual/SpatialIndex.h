@@ -0,0 +1,94 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+/**
+ * @brief 二维均匀网格空间索引
+ *
+ * 先用insert加入所有矩形，再调用build按网格分桶：每个格子的条目在一个连续数组中（CSR），
+ * 查询只访问与查询矩形相交的格子，耗时与这些格子中的条目数成正比，而不是总条目数。
+ * 跨越格子过多的矩形（例如很长的连接线）单独存放，每次查询逐个判断。
+ * 条目跨越多个格子时只在其与查询范围重叠部分的第一个格子中报告，结果不重复。
+ * build之后加入的条目放在一个小的动态桶中，每次查询逐个判断；移动的条目先remove再重新insert。
+ * 动态桶变大后调用方应clear并整体重建（dynamicSize）。
+ */
+class SpatialIndex
+{
+public:
+    /// 跨越格子数超过此值的矩形不分桶，每次查询逐个判断
+    static constexpr int MAX_ITEM_CELLS = 64;
+
+    SpatialIndex();
+
+    /**
+     * @brief 清空所有条目
+     */
+    void clear();
+
+    /**
+     * @brief 加入一个矩形
+     *
+     * build之前加入的条目在build之后才能查询到；build之后加入的条目进入动态桶，立即可以查询
+     * @param id 条目编号（查询时原样返回）
+     * @param box 条目的世界坐标范围
+     * @return 条目序号（remove时使用）
+     */
+    int insert(int id, const sf::FloatRect &box);
+
+    /**
+     * @brief 移除一个条目，之后的查询不再报告它
+     * @param item insert返回的条目序号
+     */
+    void remove(int item);
+
+    /**
+     * @brief 按网格分桶
+     *
+     * 格子数不超过条目数的两倍，条目很分散时自动放大格子，耗时O(条目数 + 格子数)
+     * @param cellSize 期望的格子边长（通常取节点尺寸的若干倍）
+     */
+    void build(float cellSize);
+
+    /**
+     * @brief 查询与矩形相交的条目
+     * @param area 查询范围
+     * @param result 输出条目编号（先清空，不保证顺序）
+     */
+    void query(const sf::FloatRect &area, std::vector<int> &result) const;
+
+    /**
+     * @brief 条目数（包括已移除的）
+     */
+    size_t size() const { return m_ids.size(); }
+
+    /**
+     * @brief build之后加入的条目数（每次查询逐个判断）
+     */
+    size_t dynamicSize() const { return m_dynamicItems.size(); }
+
+private:
+    /**
+     * @brief 坐标所在的格子列（超出范围时截到边界）
+     */
+    int cellColumn(float x) const;
+
+    /**
+     * @brief 坐标所在的格子行（超出范围时截到边界）
+     */
+    int cellRow(float y) const;
+
+    std::vector<int> m_ids;             // 条目编号（按加入顺序）
+    std::vector<sf::FloatRect> m_boxes; // 条目范围（按加入顺序）
+    std::vector<char> m_removed;        // 条目是否已移除（按加入顺序）
+
+    sf::Vector2f m_origin;           // 网格左上角
+    float m_cellSize;                // 格子边长
+    int m_columns;                   // 格子列数
+    int m_rows;                      // 格子行数
+    std::vector<int> m_cellStart;    // 每个格子在m_cellItems中的起点（多一个哨兵）
+    std::vector<int> m_cellItems;    // 按格子排列的条目序号
+    std::vector<int> m_largeItems;   // 跨越格子过多的条目序号
+    std::vector<int> m_dynamicItems; // build之后加入的条目序号
+    bool m_built;                    // 是否已经build
+};
@@ -1,6 +1,7 @@
 #include "TreeBuilder.h"
 #include <sstream>
 #include <algorithm>
+#include <unordered_set>
 
 TreeBuilder::TreeBuilder()
     : m_totalNodes(0), m_maxDepth(0), m_leafNodes(0)
@@ -16,115 +17,282 @@ std::unique_ptr<Tree> TreeBuilder::buildTree(const ISolution &solution)
 
     if (solution.size() == 0)
     {
-        return std::make_unique<Tree>();
+        return std::make_unique<Tree>(&solution);
     }
 
-    // 创建节点映射表
-    std::vector<TreeNode *> nodeMap(solution.size(), nullptr);
+    int count = static_cast<int>(solution.size());
+    std::vector<int> gathered;
+    ColumnSpan<int> parents = gatherParents(solution, gathered);
 
-    // 找到根节点（parent为-1的节点）
+    // 找到根节点（第一个parent为-1的节点），如果没有找到，使用第一个节点作为根
+    int rootIndex = static_cast<int>(std::find(parents.begin(), parents.end(), -1) - parents.begin());
+    if (rootIndex == count)
+    {
+        rootIndex = 0;
+    }
+
+    // 节点数已知，整棵树放在一块连续的节点池中
+    auto tree = std::make_unique<Tree>(&solution, solution.size());
+    tree->setRoot(buildSubtree(*tree, rootIndex, buildChildOffsets(parents)));
+
+    m_totalNodes = static_cast<int>(tree->size());
+    return tree;
+}
+
+std::unique_ptr<Tree> TreeBuilder::buildDagTree(const ISolution &solution, const TranspositionIndex &index)
+{
+    m_totalNodes = 0;
+    m_maxDepth = 0;
+    m_leafNodes = 0;
+
+    int count = static_cast<int>(solution.size());
+    if (count == 0)
+    {
+        return std::make_unique<Tree>(&solution);
+    }
+
+    std::vector<int> gathered;
+    ColumnSpan<int> parents = gatherParents(solution, gathered);
+
+    // 只有代表记录参与建树，其父节点改为原父记录的代表记录；其它记录标为-2，不建节点
+    std::vector<int> dagParents(count, -2);
     int rootIndex = -1;
-    for (size_t i = 0; i < solution.size(); ++i)
+    for (int i = 0; i < count; ++i)
     {
-        if (solution.getParent(i) == -1)
+        if (!index.isCanonical(i))
+        {
+            continue;
+        }
+        dagParents[i] = parents[i] >= 0 && parents[i] < count ? index.canonical(parents[i]) : -1;
+        if (dagParents[i] == -1 && rootIndex == -1)
         {
             rootIndex = i;
-            break;
         }
     }
-
     if (rootIndex == -1)
     {
-        // 如果没有找到根节点，使用第一个节点作为根
-        rootIndex = 0;
+        rootIndex = index.canonical(0);
     }
 
-    // 递归构建树
-    TreeNode *root = buildSubtree(rootIndex, solution, nullptr, nodeMap);
-
-    // 创建树结构
-    auto tree = std::make_unique<Tree>();
-    tree->setRoot(root);
-
-    // 收集统计信息
-    collectStats(*tree);
+    auto tree = buildTree(solution, dagParents, rootIndex);
 
+    // 其余边（重复展开产生）映射到代表记录之间，去掉与树边重复的和重复出现的
+    const FlatTree &flat = tree->getFlatTree();
+    std::unordered_set<uint64_t> seen;
+    for (int i = 0; i < count; ++i)
+    {
+        if (parents[i] < 0 || parents[i] >= count)
+        {
+            continue;
+        }
+        int from = index.canonical(parents[i]);
+        int to = index.canonical(i);
+        if (!flat.contains(from) || !flat.contains(to) || flat.parent(to) == from)
+        {
+            continue;
+        }
+        if (seen.insert((static_cast<uint64_t>(from) << 32) | static_cast<uint32_t>(to)).second)
+        {
+            tree->addMergedEdge(from, to);
+        }
+    }
     return tree;
 }
 
-TreeNode *TreeBuilder::buildSubtree(int nodeIndex, const ISolution &solution,
-                                    TreeNode *parent, std::vector<TreeNode *> &nodeMap)
+std::unique_ptr<Tree> TreeBuilder::buildTree(const ISolution &solution, ColumnSpan<int> treeParents, int rootIndex)
 {
-    // 如果节点已经创建，直接返回
-    if (nodeMap[nodeIndex] != nullptr)
+    m_totalNodes = 0;
+    m_maxDepth = 0;
+    m_leafNodes = 0;
+
+    auto tree = std::make_unique<Tree>(&solution, treeParents.size());
+    if (rootIndex < 0 || rootIndex >= static_cast<int>(treeParents.size()))
     {
-        return nodeMap[nodeIndex];
+        return tree;
     }
+    tree->setRoot(buildSubtree(*tree, rootIndex, buildChildOffsets(treeParents)));
 
-    // 创建新节点
-    const auto &state = solution.getState(nodeIndex);
-    int g = solution.getG(nodeIndex);
-    int h = solution.getH(nodeIndex);
-
-    TreeNode *node = new TreeNode(nodeIndex, state, g, h, parent);
-    nodeMap[nodeIndex] = node;
-
-    // 找到所有子节点
-    std::vector<int> children;
-    for (size_t i = 0; i < solution.size(); ++i)
+    // 不建节点的索引留有空位，节点数按实际创建的统计
+    for (const TreeNode *node : tree->getAllNodes())
     {
-        if (solution.getParent(i) == nodeIndex)
+        if (node)
         {
-            children.push_back(i);
+            m_totalNodes++;
         }
     }
+    return tree;
+}
 
-    // 递归构建子树
-    for (int childIndex : children)
+ColumnSpan<int> TreeBuilder::gatherParents(const ISolution &solution, std::vector<int> &storage)
+{
+    // 优先直接扫描连续的父节点列；数据不连续时逐元素读出一次
+    ColumnSpan<int> parents = solution.getParentColumn();
+    if (parents.size() == solution.size())
     {
-        TreeNode *child = buildSubtree(childIndex, solution, node, nodeMap);
-        node->addChild(child);
+        return parents;
     }
-
-    return node;
+    int count = static_cast<int>(solution.size());
+    storage.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        storage[i] = solution.getParent(i);
+    }
+    return storage;
 }
 
-void TreeBuilder::collectStats(const Tree &tree)
+TreeBuilder::ChildAdjacency TreeBuilder::buildChildOffsets(ColumnSpan<int> parents)
 {
-    m_totalNodes = static_cast<int>(tree.size());
-    m_maxDepth = tree.getMaxDepth();
-    m_leafNodes = 0;
+    // CSR：先按父节点计数，前缀和得到每个父节点的起始偏移，再按索引顺序填入子节点
+    int count = static_cast<int>(parents.size());
+    ChildAdjacency adjacency;
+    adjacency.offsets.assign(count + 1, 0);
+    for (int parent : parents)
+    {
+        if (parent >= 0 && parent < count)
+        {
+            adjacency.offsets[parent + 1]++;
+        }
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        adjacency.offsets[i + 1] += adjacency.offsets[i];
+    }
 
-    if (tree.getRoot())
+    adjacency.children.resize(adjacency.offsets[count]);
+    std::vector<int> next(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    for (int i = 0; i < count; ++i)
     {
-        collectStatsRecursive(tree.getRoot(), 0);
+        int parent = parents[i];
+        if (parent >= 0 && parent < count)
+        {
+            adjacency.children[next[parent]++] = i;
+        }
     }
+    return adjacency;
 }
 
-void TreeBuilder::collectStatsRecursive(TreeNode *node, int depth)
+size_t TreeBuilder::extendTree(Tree &tree, const ISolution &solution, size_t fromIndex)
 {
-    if (node == nullptr)
+    if (fromIndex == 0)
     {
-        return;
+        m_totalNodes = 0;
+        m_maxDepth = 0;
+        m_leafNodes = 0;
+        m_pendingChildren.clear();
     }
 
-    // 更新最大深度
-    if (depth > m_maxDepth)
+    size_t count = solution.size();
+    ColumnSpan<int> parentColumn = solution.getParentColumn();
+    bool contiguous = parentColumn.size() >= count;
+    for (size_t i = fromIndex; i < count; ++i)
     {
-        m_maxDepth = depth;
+        int parentIndex = contiguous ? parentColumn[i] : solution.getParent(i);
+        if (parentIndex == -1)
+        {
+            // 与buildTree一致，只保留第一个根节点所在的树
+            if (!tree.getRoot())
+            {
+                attachNode(tree, static_cast<int>(i), nullptr);
+            }
+        }
+        else if (TreeNode *parent = tree.getNodeByIndex(parentIndex))
+        {
+            attachNode(tree, static_cast<int>(i), parent);
+        }
+        else
+        {
+            m_pendingChildren[parentIndex].push_back(static_cast<int>(i));
+        }
     }
 
-    // 统计叶子节点
-    if (node->isLeaf())
+    m_totalNodes = static_cast<int>(tree.size());
+    return count;
+}
+
+void TreeBuilder::attachNode(Tree &tree, int nodeIndex, TreeNode *parent)
+{
+    std::vector<std::pair<int, TreeNode *>> stack{{nodeIndex, parent}};
+    while (!stack.empty())
     {
-        m_leafNodes++;
+        auto [index, parentNode] = stack.back();
+        stack.pop_back();
+
+        TreeNode *node = tree.createNode(index, parentNode);
+        if (parentNode)
+        {
+            // 父节点原本是叶子时叶子数不变，否则多出一个叶子
+            if (parentNode->firstChild != node)
+            {
+                m_leafNodes++;
+            }
+        }
+        else
+        {
+            tree.setRoot(node);
+            m_leafNodes = 1;
+        }
+        m_maxDepth = std::max(m_maxDepth, tree.getFlatNode(index).depth() + 1);
+
+        // 挂上之前到达的子记录，逆序入栈以保持索引顺序
+        auto pending = m_pendingChildren.find(index);
+        if (pending != m_pendingChildren.end())
+        {
+            std::vector<int> children = std::move(pending->second);
+            m_pendingChildren.erase(pending);
+            for (auto it = children.rbegin(); it != children.rend(); ++it)
+            {
+                stack.emplace_back(*it, node);
+            }
+        }
     }
+}
 
-    // 递归处理子节点
-    for (TreeNode *child : node->children)
+TreeNode *TreeBuilder::buildSubtree(Tree &tree, int rootIndex, const ChildAdjacency &adjacency)
+{
+    // 显式栈代替递归，深链（DFS/IDA*轨迹）不会爆栈；逆序入栈保持子节点顺序。
+    // 深度和叶子数在同一遍中统计
+    TreeNode *root = nullptr;
+    struct Pending
+    {
+        int index;
+        TreeNode *parent;
+        int depth;
+    };
+    std::vector<Pending> stack{{rootIndex, nullptr, 1}};
+    while (!stack.empty())
     {
-        collectStatsRecursive(child, depth + 1);
+        Pending item = stack.back();
+        stack.pop_back();
+
+        // 如果节点已经创建，跳过（没有根节点且父子关系成环时）
+        if (tree.getNodeByIndex(item.index) != nullptr)
+        {
+            continue;
+        }
+
+        // 创建新节点（状态和代价留在Solution中，节点只记录索引）
+        TreeNode *node = tree.createNode(item.index, item.parent);
+        if (!root)
+        {
+            root = node;
+        }
+
+        int first = adjacency.offsets[item.index];
+        int last = adjacency.offsets[item.index + 1];
+        m_maxDepth = std::max(m_maxDepth, item.depth);
+        if (first == last)
+        {
+            m_leafNodes++;
+            continue;
+        }
+
+        for (int i = last - 1; i >= first; --i)
+        {
+            stack.push_back({adjacency.children[i], node, item.depth + 1});
+        }
     }
+
+    return root;
 }
 
 std::string TreeBuilder::getBuildStats() const
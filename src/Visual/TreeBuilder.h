@@ -13,7 +13,10 @@
 
 #include "../Core/TreeNode.h"
 #include "../Parser/Solution.h"
+#include "../Parser/TranspositionIndex.h"
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 /**
  * @brief 树构建器，负责从Solution构建树结构
@@ -33,6 +36,38 @@ public:
      */
     std::unique_ptr<Tree> buildTree(const ISolution &solution);
 
+    /**
+     * @brief 按给定的树父节点列构建树（例如从布局缓存读取的拓扑）
+     * @param solution 提供状态和代价的解决方案
+     * @param treeParents 每个索引在树中的父节点（-1表示根，-2表示该索引不建节点）
+     * @param rootIndex 根节点索引
+     * @return 构建的树结构
+     */
+    std::unique_ptr<Tree> buildTree(const ISolution &solution, ColumnSpan<int> treeParents, int rootIndex);
+
+    /**
+     * @brief 构建合并相同状态后的DAG视图
+     *
+     * 只为代表记录建节点，代表记录的树父节点是其原父记录的代表记录；
+     * 其它重复展开产生的边去重后作为合并边保存在树中，渲染时画出多条入边。
+     * @param solution 解决方案数据
+     * @param index 置换索引
+     * @return 构建的树结构（节点数约为原来的1/重复倍数）
+     */
+    std::unique_ptr<Tree> buildDagTree(const ISolution &solution, const TranspositionIndex &index);
+
+    /**
+     * @brief 将Solution中新增的记录追加到已有的树上（用于流式加载）
+     *
+     * 父节点尚未出现的记录会暂存，等父节点到达后再挂上，子节点顺序与buildTree一致。
+     * 统计信息随之增量更新。
+     * @param tree 要扩展的树（首次调用时传入以该Solution构造的空树）
+     * @param solution 解决方案数据
+     * @param fromIndex 从该记录开始处理
+     * @return 已处理到的记录数（下次调用的fromIndex）
+     */
+    size_t extendTree(Tree &tree, const ISolution &solution, size_t fromIndex);
+
     /**
      * @brief 获取构建统计信息
      * @return 统计信息字符串
@@ -44,27 +79,48 @@ private:
     int m_maxDepth;   // 最大深度
     int m_leafNodes;  // 叶子节点数
 
+    std::unordered_map<int, std::vector<int>> m_pendingChildren; // 增量构建时父节点尚未到达的记录
+
     /**
-     * @brief 递归构建子树
-     * @param nodeIndex 当前节点索引
-     * @param solution 解决方案数据
-     * @param parent 父节点指针
-     * @param nodeMap 节点映射表
-     * @return 构建的节点
+     * @brief 创建节点并挂到父节点下，随后挂上等待该节点的子记录
+     * @param tree 树结构
+     * @param nodeIndex 节点索引
+     * @param parent 父节点指针（nullptr表示根）
      */
-    TreeNode *buildSubtree(int nodeIndex, const ISolution &solution,
-                           TreeNode *parent, std::vector<TreeNode *> &nodeMap);
+    void attachNode(Tree &tree, int nodeIndex, TreeNode *parent);
 
     /**
-     * @brief 收集统计信息
-     * @param tree 树结构
+     * @brief 子节点邻接表（CSR格式）
+     *
+     * 节点i的子节点为children[offsets[i]] .. children[offsets[i+1]-1]，按索引升序
      */
-    void collectStats(const Tree &tree);
+    struct ChildAdjacency
+    {
+        std::vector<int> offsets;  // 每个节点的子节点起始偏移（长度为记录数+1）
+        std::vector<int> children; // 按父节点分组的子节点索引
+    };
 
     /**
-     * @brief 递归收集统计信息
-     * @param node 当前节点
-     * @param depth 当前深度
+     * @brief 取得解决方案的父节点列：连续存放时直接返回列视图，否则逐元素读出到storage
+     * @param solution 解决方案
+     * @param storage 数据不连续时的存储，须比返回的视图活得久
+     * @return 长度等于solution.size()的父节点列
+     */
+    static ColumnSpan<int> gatherParents(const ISolution &solution, std::vector<int> &storage);
+
+    /**
+     * @brief 由父节点列计算子节点邻接表，O(N)
+     * @param parents 父节点列
+     * @return 子节点邻接表
+     */
+    static ChildAdjacency buildChildOffsets(ColumnSpan<int> parents);
+
+    /**
+     * @brief 在树的节点池中构建以rootIndex为根的子树（迭代实现），同时统计最大深度和叶子数
+     * @param tree 树结构
+     * @param rootIndex 子树根节点索引
+     * @param adjacency 子节点邻接表
+     * @return 构建的根节点
      */
-    void collectStatsRecursive(TreeNode *node, int depth);
+    TreeNode *buildSubtree(Tree &tree, int rootIndex, const ChildAdjacency &adjacency);
 };
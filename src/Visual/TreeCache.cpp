@@ -0,0 +1,227 @@
+#include "TreeCache.h"
+#include "TreeLayout.h"
+#include "../Parser/BinarySolution.h"
+#include "../Parser/SolutionValidator.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+static_assert(sizeof(sf::Vector2f) == 2 * sizeof(float), "node positions are stored as float pairs");
+
+namespace
+{
+    // splitmix64终混，使每个输入位影响所有输出位
+    uint64_t finalize(uint64_t h)
+    {
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        return h ^ (h >> 31);
+    }
+
+    /**
+     * @brief 缓存键字段的64位哈希：FNV-1a逐字节累加后做一次splitmix64终混
+     *
+     * 输入只有路径和几个数值字段（几十到几百字节）
+     */
+    uint64_t hashBytes(const char *data, size_t size, uint64_t seed)
+    {
+        uint64_t h = 0xCBF29CE484222325ull ^ seed;
+        for (size_t i = 0; i < size; ++i)
+            h = (h ^ static_cast<uint8_t>(data[i])) * 0x100000001B3ull;
+        return finalize(h);
+    }
+
+    std::string toHex(uint64_t value)
+    {
+        char buffer[17];
+        std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(value));
+        return buffer;
+    }
+
+    template <typename T>
+    void writeBlock(std::ofstream &out, uint64_t &offset, const std::vector<T> &values)
+    {
+        out.write(reinterpret_cast<const char *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+        offset += values.size() * sizeof(T);
+        writeFilePadding(out, offset);
+    }
+
+    // 写入临时文件成功后再改名，中途退出不会留下半个缓存文件
+    template <typename Writer>
+    void writeAtomically(const std::string &path, Writer writer)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(TreeCache::CACHE_DIRECTORY, ec);
+        std::string temporary = path + ".tmp";
+        writer(temporary);
+        std::filesystem::rename(temporary, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(temporary, ec);
+            throw std::runtime_error("Cannot write cache file: " + path);
+        }
+    }
+}
+
+namespace TreeCache
+{
+    uint64_t fileKey(const std::string &path)
+    {
+        std::error_code ec;
+        std::string absolute = std::filesystem::absolute(path, ec).string();
+        uint64_t size = std::filesystem::file_size(path, ec);
+        if (ec)
+            throw std::runtime_error("Cannot open file: " + path);
+        int64_t modified = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+        if (ec)
+            throw std::runtime_error("Cannot open file: " + path);
+
+        absolute.append(reinterpret_cast<const char *>(&size), sizeof(size));
+        absolute.append(reinterpret_cast<const char *>(&modified), sizeof(modified));
+        return hashBytes(absolute.data(), absolute.size(), 0);
+    }
+
+    uint64_t hashLayoutParameters(float horizontalSpacing, float verticalSpacing, float nodeWidth,
+                                  float nodeHeight, const sf::Vector2f &position, bool dagMode)
+    {
+        const float values[] = {horizontalSpacing, verticalSpacing, nodeWidth, nodeHeight, position.x, position.y,
+                                dagMode ? 1.0f : 0.0f};
+        return hashBytes(reinterpret_cast<const char *>(values), sizeof(values), LAYOUT_CACHE_VERSION);
+    }
+
+    std::string solutionCachePath(uint64_t sourceKey)
+    {
+        return std::string(CACHE_DIRECTORY) + "/" + toHex(sourceKey) + ".npsb";
+    }
+
+    std::string layoutCachePath(uint64_t sourceKey, uint64_t parametersHash)
+    {
+        return std::string(CACHE_DIRECTORY) + "/" + toHex(sourceKey) + "-" + toHex(parametersHash) + ".nplc";
+    }
+
+    std::unique_ptr<ISolution> openSolution(uint64_t sourceKey)
+    {
+        std::string path = solutionCachePath(sourceKey);
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec))
+            return nullptr;
+
+        try
+        {
+            auto solution = std::make_unique<BinarySolution>(path);
+            SolutionValidator::requireValid(SolutionValidator::validate(*solution), path);
+            return solution;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Ignoring invalid solution cache " << path << ": " << e.what() << std::endl;
+            return nullptr;
+        }
+    }
+
+    void storeSolution(const ISolution &solution, uint64_t sourceKey)
+    {
+        writeAtomically(solutionCachePath(sourceKey),
+                        [&](const std::string &path) { writeBinarySolution(solution, path); });
+    }
+
+    void storeLayout(const Tree &tree, const TreeLayout &layout, uint64_t sourceKey, uint64_t parametersHash)
+    {
+        const FlatTree &flat = tree.getFlatTree();
+        size_t count = tree.size();
+        std::vector<int32_t> parents(count, -2);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (flat.contains(static_cast<int>(i)))
+                parents[i] = flat.parent(static_cast<int>(i));
+        }
+
+        std::vector<sf::Vector2f> positions = layout.getAllNodePositions();
+        positions.resize(count);
+
+        std::vector<int32_t> merged;
+        merged.reserve(tree.getMergedEdges().size() * 2);
+        for (const auto &[from, to] : tree.getMergedEdges())
+        {
+            merged.push_back(from);
+            merged.push_back(to);
+        }
+
+        NplcHeader header = {};
+        std::memcpy(header.magic, "NPLC", 4);
+        header.version = LAYOUT_CACHE_VERSION;
+        header.sourceKey = sourceKey;
+        header.parametersHash = parametersHash;
+        header.count = count;
+        header.root = tree.getRoot() ? tree.getRoot()->index : -1;
+        header.mergedCount = tree.getMergedEdges().size();
+        header.parentsOffset = alignFileOffset(sizeof(NplcHeader));
+        header.positionsOffset = header.parentsOffset + alignFileOffset(count * sizeof(int32_t));
+        header.mergedOffset = header.positionsOffset + alignFileOffset(count * sizeof(sf::Vector2f));
+
+        writeAtomically(layoutCachePath(sourceKey, parametersHash), [&](const std::string &path)
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out.is_open())
+                throw std::runtime_error("Cannot open file: " + path);
+
+            uint64_t offset = sizeof(NplcHeader);
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            writeFilePadding(out, offset);
+            writeBlock(out, offset, parents);
+            writeBlock(out, offset, positions);
+            writeBlock(out, offset, merged);
+            if (!out)
+                throw std::runtime_error("Failed to write layout cache: " + path);
+        });
+    }
+
+    CachedLayout::CachedLayout(const std::string &path, uint64_t sourceKey, uint64_t parametersHash)
+        : m_file(path), m_count(0), m_root(-1), m_parents(nullptr), m_positions(nullptr),
+          m_merged(nullptr), m_mergedCount(0)
+    {
+        if (m_file.size() < sizeof(NplcHeader))
+            throw std::runtime_error("Layout cache file is truncated: " + path);
+
+        NplcHeader header;
+        std::memcpy(&header, m_file.data(), sizeof(header));
+        if (std::memcmp(header.magic, "NPLC", 4) != 0)
+            throw std::runtime_error("Not a layout cache file: " + path);
+        if (header.version != LAYOUT_CACHE_VERSION)
+            throw std::runtime_error("Unsupported layout cache version: " + std::to_string(header.version));
+        if (header.sourceKey != sourceKey || header.parametersHash != parametersHash)
+            throw std::runtime_error("Layout cache key mismatch: " + path);
+
+        // 与BinarySolution相同：先用文件大小约束计数再做乘法，范围比较写成减法形式
+        uint64_t size = m_file.size();
+        if (header.count > size / sizeof(sf::Vector2f) || header.mergedCount > size / (2 * sizeof(int32_t)))
+            throw std::runtime_error("Layout cache format error: record count exceeds file size");
+        auto outOfRange = [size](uint64_t offset, uint64_t bytes, size_t alignment)
+        {
+            return offset % alignment != 0 || offset > size || bytes > size - offset;
+        };
+        if (outOfRange(header.parentsOffset, header.count * sizeof(int32_t), alignof(int32_t)) ||
+            outOfRange(header.positionsOffset, header.count * sizeof(sf::Vector2f), alignof(float)) ||
+            outOfRange(header.mergedOffset, header.mergedCount * 2 * sizeof(int32_t), alignof(int32_t)))
+            throw std::runtime_error("Layout cache format error: column out of range");
+        if (header.root < 0 || static_cast<uint64_t>(header.root) >= header.count)
+            throw std::runtime_error("Layout cache format error: root out of range");
+
+        m_count = static_cast<size_t>(header.count);
+        m_root = header.root;
+        m_parents = reinterpret_cast<const int32_t *>(m_file.data() + header.parentsOffset);
+        m_positions = reinterpret_cast<const sf::Vector2f *>(m_file.data() + header.positionsOffset);
+        m_merged = reinterpret_cast<const int32_t *>(m_file.data() + header.mergedOffset);
+        m_mergedCount = static_cast<size_t>(header.mergedCount);
+    }
+
+    void CachedLayout::restoreMergedEdges(Tree &tree) const
+    {
+        for (size_t i = 0; i < m_mergedCount; ++i)
+            tree.addMergedEdge(m_merged[2 * i], m_merged[2 * i + 1]);
+    }
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "../Core/TreeNode.h"
+#include "../Parser/MappedFile.h"
+#include "../Parser/Solution.h"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class TreeLayout;
+
+/**
+ * @brief .nplc 树与布局缓存文件头
+ *
+ * 文件布局（小端、按8字节对齐）：
+ * [NplcHeader][treeParents int32 x count][positions float x 2 x count][mergedEdges int32 x 2 x mergedCount]
+ */
+struct NplcHeader
+{
+    char magic[4];            ///< 固定为 "NPLC"
+    uint32_t version;         ///< 格式及布局算法版本
+    uint64_t sourceKey;       ///< 解决方案文件键（路径、大小和修改时间的哈希）
+    uint64_t parametersHash;  ///< 布局参数哈希
+    uint64_t count;           ///< 索引数量（树的最大节点索引+1）
+    int32_t root;             ///< 根节点索引
+    uint32_t reserved;        ///< 保留，写0
+    uint64_t mergedCount;     ///< 合并边数量
+    uint64_t parentsOffset;   ///< 树父节点列的文件偏移（-2表示该索引没有节点）
+    uint64_t positionsOffset; ///< 节点位置列的文件偏移
+    uint64_t mergedOffset;    ///< 合并边的文件偏移
+};
+
+/**
+ * @brief 树和布局的持久化缓存
+ *
+ * 以解决方案文件的路径、大小和修改时间的哈希为键（不读取文件内容），缓存目录中保存两类文件：
+ * 文本解决方案转换成的 .npsb（再次打开时直接映射，不再解析文本），
+ * 以及以文件键和布局参数哈希共同为键的 .nplc（树拓扑和所有节点位置）。
+ * 布局算法改变时须增加 LAYOUT_CACHE_VERSION，使旧缓存失效。
+ */
+namespace TreeCache
+{
+    /// 当前写出的 .nplc 版本（布局算法改变时递增）
+    constexpr uint32_t LAYOUT_CACHE_VERSION = 2;
+
+    /// 默认缓存目录
+    constexpr const char *CACHE_DIRECTORY = ".npcache";
+
+    /**
+     * @brief 计算文件的缓存键：绝对路径、大小和修改时间的64位哈希
+     *
+     * 只读取文件元数据，与文件大小无关，可以直接在界面线程调用；文件被改写后键随之改变
+     * @param path 文件路径
+     * @throws std::runtime_error 文件不存在
+     */
+    uint64_t fileKey(const std::string &path);
+
+    /**
+     * @brief 计算布局参数的哈希
+     */
+    uint64_t hashLayoutParameters(float horizontalSpacing, float verticalSpacing, float nodeWidth,
+                                  float nodeHeight, const sf::Vector2f &position, bool dagMode);
+
+    /**
+     * @brief 解决方案缓存（.npsb）路径
+     */
+    std::string solutionCachePath(uint64_t sourceKey);
+
+    /**
+     * @brief 树与布局缓存（.nplc）路径
+     */
+    std::string layoutCachePath(uint64_t sourceKey, uint64_t parametersHash);
+
+    /**
+     * @brief 打开缓存的解决方案（映射后在列上做语义校验，校验失败视为缓存无效）
+     * @param sourceKey 源文件键（fileKey）
+     * @return 解决方案，缓存不存在或无效时返回nullptr
+     */
+    std::unique_ptr<ISolution> openSolution(uint64_t sourceKey);
+
+    /**
+     * @brief 将完整的解决方案写入缓存（先写临时文件再改名）
+     * @param solution 解决方案（须已加载完成）
+     * @param sourceKey 源文件键（fileKey）
+     */
+    void storeSolution(const ISolution &solution, uint64_t sourceKey);
+
+    /**
+     * @brief 将树拓扑和布局写入缓存（先写临时文件再改名）
+     * @param tree 树结构
+     * @param layout 已计算的布局
+     * @param sourceKey 源文件键（fileKey）
+     * @param parametersHash 布局参数哈希
+     */
+    void storeLayout(const Tree &tree, const TreeLayout &layout, uint64_t sourceKey, uint64_t parametersHash);
+
+    /**
+     * @brief 映射的树与布局缓存
+     *
+     * 打开时只校验文件头，各列直接指向映射内存
+     */
+    class CachedLayout
+    {
+    public:
+        /**
+         * @brief 构造函数，映射并校验 .nplc 文件
+         * @throws std::runtime_error 文件无效、版本或键不匹配
+         */
+        CachedLayout(const std::string &path, uint64_t sourceKey, uint64_t parametersHash);
+
+        int root() const { return m_root; }
+        ColumnSpan<int> treeParents() const { return {m_parents, m_count}; }
+        const sf::Vector2f *positions() const { return m_positions; }
+        size_t size() const { return m_count; }
+
+        /**
+         * @brief 将缓存中的合并边加入树
+         */
+        void restoreMergedEdges(Tree &tree) const;
+
+    private:
+        MappedFile m_file;               ///< 映射的 .nplc 文件
+        size_t m_count;                  ///< 索引数量
+        int m_root;                      ///< 根节点索引
+        const int32_t *m_parents;        ///< 树父节点列
+        const sf::Vector2f *m_positions; ///< 节点位置列
+        const int32_t *m_merged;         ///< 合并边（起点, 终点）对
+        size_t m_mergedCount;            ///< 合并边数量
+    };
+}
@@ -1,13 +1,36 @@
 #include "TreeLayout.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <exception>
 #include <limits>
+#include <numeric>
+#include <thread>
+#include <utility>
 #include <vector>
-#include <queue>
+
+namespace
+{
+    // 节点数低于此值时串行布局（线程启动和切分的开销大于收益）
+    constexpr size_t PARALLEL_LAYOUT_MIN_NODES = size_t(1) << 16;
+
+    // 每个线程平均分到的任务数，任务大小不均时由先完成的线程领取剩余任务
+    constexpr size_t TASKS_PER_THREAD = 8;
+
+    /**
+     * @brief 一段连续的兄弟子树，作为一个并行任务
+     */
+    struct SubtreeRun
+    {
+        int first;   // 第一个子树根
+        int count;   // 子树数量
+        size_t size; // 节点总数
+    };
+}
 
 TreeLayout::TreeLayout()
     : m_tree(nullptr), m_horizontalSpacing(200.0f), m_verticalSpacing(150.0f),
-      m_nodeWidth(80.0f), m_nodeHeight(80.0f), m_position(0, 0), m_nextX(0.0f), m_inorderStep(0.0f)
+      m_nodeWidth(80.0f), m_nodeHeight(80.0f), m_position(0, 0), m_threadCount(0), m_layoutMode(LayoutMode::Layered), m_revision(0), m_incremental(false)
 {
 }
 
@@ -24,6 +47,7 @@ void TreeLayout::setTree(Tree *tree)
         m_change.resize(nodeCount, 0.0f);
         m_thread.resize(nodeCount, -1);
         m_ancestor.resize(nodeCount, -1);
+        m_number.resize(nodeCount, 0);
 
         // 根据树的大小动态调整节点尺寸和间距
         calculateAdaptiveParameters();
@@ -39,6 +63,21 @@ void TreeLayout::setLayoutParameters(float horizontalSpacing, float verticalSpac
     m_nodeHeight = nodeHeight;
 }
 
+void TreeLayout::setLayoutMode(LayoutMode mode)
+{
+    m_layoutMode = mode;
+}
+
+LayoutMode TreeLayout::getLayoutMode() const
+{
+    return m_layoutMode;
+}
+
+void TreeLayout::setThreadCount(unsigned threadCount)
+{
+    m_threadCount = threadCount;
+}
+
 void TreeLayout::calculateLayout()
 {
     if (!m_tree || !m_tree->getRoot())
@@ -47,6 +86,9 @@ void TreeLayout::calculateLayout()
     }
 
     calculateAdaptiveParameters();
+    m_incremental = false;
+    m_changedNodes.clear();
+    ++m_revision;
 
     int nodeCount = m_tree->size();
     if (static_cast<int>(m_nodePositions.size()) != nodeCount)
@@ -58,6 +100,7 @@ void TreeLayout::calculateLayout()
         m_change.assign(nodeCount, 0.0f);
         m_thread.assign(nodeCount, -1);
         m_ancestor.assign(nodeCount, -1);
+        m_number.assign(nodeCount, 0);
     }
     else
     {
@@ -68,10 +111,131 @@ void TreeLayout::calculateLayout()
         std::fill(m_change.begin(), m_change.end(), 0.0f);
         std::fill(m_thread.begin(), m_thread.end(), -1);
         std::fill(m_ancestor.begin(), m_ancestor.end(), -1);
+        std::fill(m_number.begin(), m_number.end(), 0);
     }
 
-    // 使用稳定方案：inorder 给叶子编号 -> 内部节点取子树中点 -> 层级轮廓冲突修正
-    executeStableLayout();
+    if (m_layoutMode == LayoutMode::Radial)
+        executeRadialLayout();
+    else
+        executeReingoldTilford();
+}
+
+void TreeLayout::setNodePositions(const sf::Vector2f *positions, size_t count)
+{
+    // 与calculateLayout一致先得到自适应的节点尺寸，getTotalSize依赖它们
+    calculateAdaptiveParameters();
+    m_incremental = false;
+    m_changedNodes.clear();
+    ++m_revision;
+    m_nodePositions.assign(positions, positions + count);
+}
+
+void TreeLayout::beginIncrementalLayout()
+{
+    m_incremental = true;
+    ++m_revision;
+    calculateAdaptiveParameters();
+
+    size_t nodeCount = m_tree ? m_tree->size() : 0;
+    m_nodePositions.assign(nodeCount, m_position);
+    m_placed.assign(nodeCount, 0);
+    m_firstPlacedChild.assign(nodeCount, FlatTree::NONE);
+    m_lastPlacedChild.assign(nodeCount, FlatTree::NONE);
+    m_levelLast.clear();
+    m_changedNodes.clear();
+}
+
+void TreeLayout::revealNode(int nodeIndex)
+{
+    if (!m_incremental || !m_tree)
+        return;
+
+    FlatNode node = m_tree->getFlatNode(nodeIndex);
+    if (!node)
+        return;
+
+    // 流式加载时树在增量布局期间继续增长
+    size_t nodeCount = m_tree->size();
+    if (m_placed.size() < nodeCount)
+    {
+        m_nodePositions.resize(nodeCount, m_position);
+        m_placed.resize(nodeCount, 0);
+        m_firstPlacedChild.resize(nodeCount, FlatTree::NONE);
+        m_lastPlacedChild.resize(nodeCount, FlatTree::NONE);
+    }
+    if (m_placed[nodeIndex])
+        return;
+
+    // 按索引顺序显示时父节点总是先放置；否则自上而下补放未放置的祖先
+    if (!node.isRoot() && !m_placed[node.parent().index])
+    {
+        std::vector<FlatNode> ancestors;
+        for (FlatNode ancestor = node.parent(); ancestor && !m_placed[ancestor.index]; ancestor = ancestor.parent())
+            ancestors.push_back(ancestor);
+        for (auto it = ancestors.rbegin(); it != ancestors.rend(); ++it)
+            placeIncremental(*it);
+    }
+    placeIncremental(node);
+}
+
+bool TreeLayout::isIncremental() const
+{
+    return m_incremental;
+}
+
+void TreeLayout::placeIncremental(FlatNode node)
+{
+    int depth = node.depth();
+    if (depth >= static_cast<int>(m_levelLast.size()))
+        m_levelLast.resize(depth + 1, FlatTree::NONE);
+
+    // 紧接所在层最右节点放置，同层节点保持显示顺序且间距不小于一个步长
+    float x = m_position.x;
+    int levelLast = m_levelLast[depth];
+    if (levelLast != FlatTree::NONE)
+        x = m_nodePositions[levelLast].x + m_nodeWidth + m_horizontalSpacing;
+
+    FlatNode parent = node.parent();
+    if (parent)
+    {
+        if (m_firstPlacedChild[parent.index] == FlatTree::NONE)
+        {
+            x = std::max(x, m_nodePositions[parent.index].x);
+            m_firstPlacedChild[parent.index] = node.index;
+        }
+        m_lastPlacedChild[parent.index] = node.index;
+    }
+
+    m_nodePositions[node.index] = sf::Vector2f(x, m_position.y + depth * (m_verticalSpacing + m_nodeHeight));
+    m_placed[node.index] = 1;
+    m_levelLast[depth] = node.index;
+    m_changedNodes.push_back(node.index);
+
+    // 祖先只向右移到首末子节点中点；右侧已有同层节点的祖先不能再动，更上层也随之不变
+    for (FlatNode ancestor = parent; ancestor; ancestor = ancestor.parent())
+    {
+        float center = (m_nodePositions[m_firstPlacedChild[ancestor.index]].x +
+                        m_nodePositions[m_lastPlacedChild[ancestor.index]].x) / 2.0f;
+        if (center <= m_nodePositions[ancestor.index].x || m_levelLast[ancestor.depth()] != ancestor.index)
+            break;
+        m_nodePositions[ancestor.index].x = center;
+        m_changedNodes.push_back(ancestor.index);
+    }
+}
+
+bool TreeLayout::isNodePlaced(int nodeIndex) const
+{
+    if (nodeIndex < 0 || nodeIndex >= static_cast<int>(m_nodePositions.size()))
+        return false;
+    // DAG视图中合并掉的索引不在树中，位置停留在(0,0)
+    if (m_tree && !m_tree->getFlatTree().contains(nodeIndex))
+        return false;
+    return !m_incremental || m_placed[nodeIndex];
+}
+
+uint64_t TreeLayout::getRevision() const
+{
+    return m_revision;
 }
 
 sf::Vector2f TreeLayout::getNodePosition(int nodeIndex) const
@@ -93,12 +257,16 @@ sf::Vector2f TreeLayout::getTotalSize() const
     if (m_nodePositions.empty())
         return sf::Vector2f(0, 0);
 
+    // 只统计有位置的节点
     float minX = std::numeric_limits<float>::max();
     float maxX = std::numeric_limits<float>::lowest();
     float maxY = std::numeric_limits<float>::lowest();
 
-    for (const auto &pos : m_nodePositions)
+    for (int index = 0; index < static_cast<int>(m_nodePositions.size()); ++index)
     {
+        if (!isNodePlaced(index))
+            continue;
+        const sf::Vector2f &pos = m_nodePositions[index];
         if (pos.x < minX)
             minX = pos.x;
         if (pos.x > maxX)
@@ -106,6 +274,8 @@ sf::Vector2f TreeLayout::getTotalSize() const
         if (pos.y > maxY)
             maxY = pos.y;
     }
+    if (minX > maxX)
+        return sf::Vector2f(0, 0);
 
     return sf::Vector2f(maxX - minX + m_nodeWidth, maxY + m_nodeHeight);
 }
@@ -116,159 +286,401 @@ void TreeLayout::setPosition(float x, float y)
 }
 
 //////////////////////////////////////////////////////////////////////////
-// 新的稳定实现：inorder + 轮廓冲突校正（不会产生 thread 相关死循环）
+// Buchheim-Walker 布局：每个节点只在两次遍历中各访问一次，
+// 兄弟子树的冲突沿线程化的轮廓检测，平移通过 mod/shift/change 延迟执行，总耗时 O(N)
 //////////////////////////////////////////////////////////////////////////
 
-// 主流程
-void TreeLayout::executeStableLayout()
+void TreeLayout::executeReingoldTilford()
 {
-    TreeNode *root = m_tree->getRoot();
+    FlatNode root = m_tree->getFlatNode(m_tree->getRoot()->index);
     if (!root) return;
 
-    // 给叶子一个连续的 x（inorder）
-    m_nextX = 0.0f;
-    float baseStep = m_nodeWidth + m_horizontalSpacing;
-    m_inorderStep = baseStep;
-    assignPrelimInorder(root);
-
-    // 对每个内部节点，prelim 是第一与最后子节点的中点（在 assignPrelimInorder 中已处理）
-    // 接着，针对每个节点的子树做兄弟间冲突修正（从上到下/后序均可）
-    resolveConflictsRec(root);
-
-    // secondWalk：计算最终 world 坐标
-    secondWalk(root, 0.0f);
+    unsigned threadCount = m_threadCount ? m_threadCount : std::max(1u, std::thread::hardware_concurrency());
+    if (threadCount == 1 || !executeParallel(root, threadCount))
+    {
+        firstWalk(root, nullptr);
+        secondWalk(root, 0.0f, nullptr, nullptr, nullptr);
+    }
 
     // 归一化，使最小 x >= m_position.x
     normalizePositions();
 }
 
-// 中序遍历：为叶子分配 x；为内部节点设置初步 prelim（平均子节点）
-void TreeLayout::assignPrelimInorder(TreeNode *node)
+//////////////////////////////////////////////////////////////////////////
+// 径向布局：角度区间按子树叶子数分配，画布边长只取决于最大深度
+//////////////////////////////////////////////////////////////////////////
+
+void TreeLayout::executeRadialLayout()
 {
-    if (!node) return;
+    FlatNode root = m_tree->getFlatNode(m_tree->getRoot()->index);
+    if (!root) return;
+
+    const FlatTree &flat = m_tree->getFlatTree();
+    size_t nodeCount = m_tree->size();
 
-    if (node->children.empty())
+    // 先序序列：父节点总在子节点之前
+    std::vector<int> order;
+    order.reserve(static_cast<size_t>(root.subtreeSize()));
+    std::vector<int> stack{root.index};
+    while (!stack.empty())
     {
-        // 叶子：直接赋值并推进 nextX
-        m_prelim[node->index] = m_nextX;
-        m_nextX += m_inorderStep;
+        int node = stack.back();
+        stack.pop_back();
+        order.push_back(node);
+        for (int child = flat.firstChild(node); child != FlatTree::NONE; child = flat.nextSibling(child))
+            stack.push_back(child);
     }
-    else
+
+    // 逆先序累加叶子数
+    std::vector<int> leaves(nodeCount, 0);
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
     {
-        // 对每个子节点递归
-        for (TreeNode *child : node->children)
-        {
-            assignPrelimInorder(child);
-        }
+        int node = *it;
+        if (flat.firstChild(node) == FlatTree::NONE)
+            leaves[node] = 1;
+        int parent = flat.parent(node);
+        if (parent != FlatTree::NONE)
+            leaves[parent] += leaves[node];
+    }
 
-        // 将当前节点放到最左子与最右子中点
-        TreeNode *leftmost = getLeftmostChild(node);
-        TreeNode *rightmost = getRightmostChild(node);
-        if (leftmost && rightmost)
-        {
-            m_prelim[node->index] = (m_prelim[leftmost->index] + m_prelim[rightmost->index]) / 2.0f;
-        }
-        else
+    // 角度区间起点放在m_prelim、宽度放在m_mod，先序时父节点的区间总是已经确定
+    const float fullCircle = 6.2831853f;
+    float ringSpacing = m_verticalSpacing + m_nodeHeight;
+    float outerRadius = flat.maxDepth() * ringSpacing;
+    sf::Vector2f center(m_position.x + outerRadius + m_nodeWidth / 2.0f, m_position.y + outerRadius + m_nodeHeight / 2.0f);
+
+    m_prelim[root.index] = 0.0f;
+    m_mod[root.index] = fullCircle;
+    for (int node : order)
+    {
+        float start = m_prelim[node];
+        float width = m_mod[node];
+        float angle = start + width / 2.0f;
+        float radius = flat.depth(node) * ringSpacing;
+        m_nodePositions[node] = sf::Vector2f(center.x + radius * std::cos(angle) - m_nodeWidth / 2.0f,
+                                             center.y + radius * std::sin(angle) - m_nodeHeight / 2.0f);
+
+        float perLeaf = width / leaves[node];
+        for (int child = flat.firstChild(node); child != FlatTree::NONE; child = flat.nextSibling(child))
         {
-            // 防御性处理（不应发生）
-            m_prelim[node->index] = 0.0f;
+            m_prelim[child] = start;
+            m_mod[child] = perLeaf * leaves[child];
+            start += m_mod[child];
         }
     }
 }
 
-// 计算并返回子树每层最小 x（leftContour）与最大 x（rightContour）
-void TreeLayout::collectContours(TreeNode *node, const std::vector<float> &prelim, std::vector<float> &minAtDepth, std::vector<float> &maxAtDepth, int depth)
+bool TreeLayout::executeParallel(FlatNode root, unsigned threadCount)
 {
-    if (!node) return;
-    float x = prelim[node->index];
-    if (static_cast<int>(minAtDepth.size()) <= depth)
+    const FlatTree *flat = root.tree;
+    size_t nodeCount = static_cast<size_t>(root.subtreeSize());
+    if (nodeCount < PARALLEL_LAYOUT_MIN_NODES)
+        return false;
+
+    // 自上而下切分：不超过grain的子树归入任务，同一父节点下相邻的小子树合并成一段；
+    // 更大的子树继续向下切分，它们的根组成串行处理的上层部分
+    size_t grain = std::max<size_t>(1024, nodeCount / (threadCount * TASKS_PER_THREAD));
+    std::vector<char> walked(m_tree->size(), 0);
+    std::vector<int> runOf(m_tree->size(), -1);
+    std::vector<SubtreeRun> runs;
+
+    SubtreeRun run = {FlatTree::NONE, 0, 0};
+    auto flush = [&]()
     {
-        minAtDepth.resize(depth + 1, std::numeric_limits<float>::infinity());
-        maxAtDepth.resize(depth + 1, -std::numeric_limits<float>::infinity());
+        if (run.count == 0)
+            return;
+        runOf[run.first] = static_cast<int>(runs.size());
+        runs.push_back(run);
+        run = {FlatTree::NONE, 0, 0};
+    };
+
+    std::vector<int> pending{root.index};
+    while (!pending.empty())
+    {
+        int node = pending.back();
+        pending.pop_back();
+        for (int child = flat->firstChild(node); child != FlatTree::NONE; child = flat->nextSibling(child))
+        {
+            size_t size = static_cast<size_t>(flat->subtreeSize(child));
+            if (size > grain)
+            {
+                flush();
+                pending.push_back(child);
+                continue;
+            }
+            if (run.count == 0)
+                run.first = child;
+            run.count++;
+            run.size += size;
+            walked[child] = 1;
+            if (run.size >= grain)
+                flush();
+        }
+        flush();
     }
-    minAtDepth[depth] = std::min(minAtDepth[depth], x);
-    maxAtDepth[depth] = std::max(maxAtDepth[depth], x);
+    if (runs.size() < 2)
+        return false;
 
-    for (TreeNode *c : node->children)
+    // 大任务先领取，减少最后只剩一个长任务在运行的时间
+    std::vector<size_t> order(runs.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                     { return runs[a].size > runs[b].size; });
+
+    auto forEachTask = [&](auto task)
     {
-        collectContours(c, prelim, minAtDepth, maxAtDepth, depth + 1);
-    }
+        std::atomic<size_t> next(0);
+        std::vector<std::exception_ptr> errors(threadCount);
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threadCount; ++t)
+        {
+            workers.emplace_back([&, t]()
+                                 {
+                try
+                {
+                    for (size_t i = next++; i < order.size(); i = next++)
+                        task(runs[order[i]], order[i]);
+                }
+                catch (...)
+                {
+                    errors[t] = std::current_exception();
+                } });
+        }
+        for (auto &worker : workers)
+            worker.join();
+        for (const auto &error : errors)
+        {
+            if (error)
+                std::rethrow_exception(error);
+        }
+    };
+
+    // 第一遍：各段子树互不相交，写入的工作列也互不重叠，可以并行；
+    // 上层部分随后串行完成，把每个子树根按左兄弟重新放置并沿轮廓分配，与串行顺序一致
+    forEachTask([&](const SubtreeRun &task, size_t)
+                {
+        int child = task.first;
+        for (int i = 0; i < task.count; ++i, child = flat->nextSibling(child))
+            firstWalk(FlatNode{flat, child}, nullptr); });
+    firstWalk(root, &walked);
+
+    // 第二遍：先串行计算上层部分并得到每段的祖先修正值之和，再并行计算各段
+    std::vector<float> runModSums(runs.size(), 0.0f);
+    secondWalk(root, 0.0f, &walked, &runOf, &runModSums);
+    forEachTask([&](const SubtreeRun &task, size_t id)
+                {
+        int child = task.first;
+        for (int i = 0; i < task.count; ++i, child = flat->nextSibling(child))
+            secondWalk(FlatNode{flat, child}, runModSums[id], nullptr, nullptr, nullptr); });
+    return true;
 }
 
-// 将整个子树的 prelim（相对坐标）整体右移 shift（递归）
-void TreeLayout::shiftSubtree(TreeNode *node, float shift)
+void TreeLayout::firstWalk(FlatNode root, const std::vector<char> *walked)
 {
-    if (!node) return;
-    std::queue<TreeNode*> q;
-    q.push(node);
-    while (!q.empty())
+    // 显式栈模拟后序递归：child 是下一个待处理的子节点，previous 是已放置的上一个子节点
+    // 只存索引，单链深树时栈也只占每层16字节
+    struct Frame
     {
-        TreeNode *cur = q.front(); q.pop();
-        m_prelim[cur->index] += shift;
-        for (TreeNode *c : cur->children)
-            q.push(c);
-    }
-}
+        int node;
+        int child;
+        int previous;
+        int defaultAncestor;
+    };
 
-// 对一个节点的所有子节点（从左到右）检测并解决兄弟子树冲突
-void TreeLayout::resolveConflictsRec(TreeNode *node)
-{
-    if (!node) return;
+    const FlatTree *flat = root.tree;
+    auto handle = [flat](int index) { return FlatNode{flat, index}; };
+    std::vector<int> siblings;
 
-    // 先处理子节点
-    for (TreeNode *child : node->children)
-        resolveConflictsRec(child);
+    m_ancestor[root.index] = root.index;
+    std::vector<Frame> stack;
+    stack.push_back({root.index, flat->firstChild(root.index), FlatTree::NONE, flat->firstChild(root.index)});
 
-    // 对兄弟子树逐对检查右边子树是否与左边子树重叠，若重叠则右移右子树
-    for (size_t i = 1; i < node->children.size(); ++i)
+    while (!stack.empty())
     {
-        TreeNode *leftSub = node->children[i - 1];
-        TreeNode *rightSub = node->children[i];
-
-        // 计算左右两个子树的轮廓（按深度）
-        std::vector<float> leftMax, leftMin;
-        std::vector<float> rightMax, rightMin;
+        Frame &frame = stack.back();
+        if (frame.child != FlatTree::NONE)
+        {
+            int child = frame.child;
+            m_ancestor[child] = child;
+            m_number[child] = frame.previous != FlatTree::NONE ? m_number[frame.previous] + 1 : 0;
+
+            // 已完成第一遍的子树与叶子一样，只需放置根节点并与左兄弟分配
+            int grandchild = flat->firstChild(child);
+            if (grandchild != FlatTree::NONE && !(walked && (*walked)[child]))
+            {
+                // 先完成子节点的子树，返回后再与左侧兄弟分配
+                stack.push_back({child, grandchild, FlatTree::NONE, grandchild});
+                continue;
+            }
+
+            placeNode(handle(child), handle(frame.previous));
+            frame.defaultAncestor = apportion(handle(child), handle(frame.previous),
+                                              handle(flat->firstChild(frame.node)), handle(frame.defaultAncestor)).index;
+            frame.previous = child;
+            frame.child = flat->nextSibling(child);
+            continue;
+        }
 
-        collectContours(leftSub, m_prelim, leftMin, leftMax, 0);
-        collectContours(rightSub, m_prelim, rightMin, rightMax, 0);
+        // 所有子节点已处理完：执行累计的平移，再放置当前节点
+        int node = frame.node;
+        executeShifts(handle(node), siblings);
+        stack.pop_back();
 
-        // 比较每一层，计算需要右移的最大值
-        float needed = 0.0f;
-        int levels = std::min(static_cast<int>(leftMax.size()), static_cast<int>(rightMin.size()));
-        for (int d = 0; d < levels; ++d)
+        if (stack.empty())
         {
-            float requiredSeparation = m_nodeWidth + m_horizontalSpacing;
-            float overlap = (leftMax[d] + requiredSeparation) - rightMin[d];
-            if (overlap > needed) needed = overlap;
+            placeNode(handle(node), handle(FlatTree::NONE));
+            break;
         }
 
-        if (needed > 0.0f)
+        Frame &parent = stack.back();
+        placeNode(handle(node), handle(parent.previous));
+        parent.defaultAncestor = apportion(handle(node), handle(parent.previous),
+                                           handle(flat->firstChild(parent.node)), handle(parent.defaultAncestor)).index;
+        parent.previous = node;
+        parent.child = flat->nextSibling(node);
+    }
+}
+
+void TreeLayout::placeNode(FlatNode node, FlatNode leftSibling)
+{
+    float distance = m_nodeWidth + m_horizontalSpacing;
+
+    if (node.isLeaf())
+    {
+        m_prelim[node.index] = leftSibling ? m_prelim[leftSibling.index] + distance : 0.0f;
+        return;
+    }
+
+    // 父节点居中于最左子与最右子之上
+    float midpoint = (m_prelim[node.firstChild().index] + m_prelim[node.lastChild().index]) / 2.0f;
+    if (leftSibling)
+    {
+        m_prelim[node.index] = m_prelim[leftSibling.index] + distance;
+        m_mod[node.index] = m_prelim[node.index] - midpoint;
+    }
+    else
+    {
+        m_prelim[node.index] = midpoint;
+    }
+}
+
+FlatNode TreeLayout::apportion(FlatNode node, FlatNode leftSibling, FlatNode leftmostSibling, FlatNode defaultAncestor)
+{
+    if (!leftSibling)
+        return defaultAncestor;
+
+    float distance = m_nodeWidth + m_horizontalSpacing;
+
+    // i = inner, o = outer；r 为当前子树一侧的轮廓，l 为左侧兄弟森林一侧的轮廓
+    FlatNode insideRight = node;
+    FlatNode outsideRight = node;
+    FlatNode insideLeft = leftSibling;
+    FlatNode outsideLeft = leftmostSibling;
+    float modInsideRight = m_mod[insideRight.index];
+    float modOutsideRight = m_mod[outsideRight.index];
+    float modInsideLeft = m_mod[insideLeft.index];
+    float modOutsideLeft = m_mod[outsideLeft.index];
+
+    for (FlatNode nextInsideLeft = nextRight(insideLeft), nextInsideRight = nextLeft(insideRight);
+         nextInsideLeft && nextInsideRight;
+         nextInsideLeft = nextRight(insideLeft), nextInsideRight = nextLeft(insideRight))
+    {
+        insideLeft = nextInsideLeft;
+        insideRight = nextInsideRight;
+        outsideLeft = nextLeft(outsideLeft);
+        outsideRight = nextRight(outsideRight);
+        m_ancestor[outsideRight.index] = node.index;
+
+        float shift = (m_prelim[insideLeft.index] + modInsideLeft) - (m_prelim[insideRight.index] + modInsideRight) + distance;
+        if (shift > 0.0f)
         {
-            // 右移整个 rightSub 树
-            shiftSubtree(rightSub, needed);
-
-            // IMPORTANT: 当右子树被右移后，可能会与下一个兄弟再次冲突，
-            // 因此需要重新比较这个新的右子树与其新的左兄弟（通常循环会继续并处理后续兄弟）
-            // 为了保证最近的左兄弟不是仅上一项，我们应将 i 回退一步以重新比较
-            // 但简单起见：把 i 回退到 max(1, i-1) 确保父级的最近兄弟链得到再检查
-            if (i > 1) --i;
+            moveSubtree(getAncestor(insideLeft, node, defaultAncestor), node, shift);
+            modInsideRight += shift;
+            modOutsideRight += shift;
         }
+
+        modInsideLeft += m_mod[insideLeft.index];
+        modInsideRight += m_mod[insideRight.index];
+        modOutsideLeft += m_mod[outsideLeft.index];
+        modOutsideRight += m_mod[outsideRight.index];
+    }
+
+    // 一侧轮廓更深时用线程把较短一侧接到另一侧的下一层
+    if (nextRight(insideLeft) && !nextRight(outsideRight))
+    {
+        m_thread[outsideRight.index] = nextRight(insideLeft).index;
+        m_mod[outsideRight.index] += modInsideLeft - modOutsideRight;
+    }
+    if (nextLeft(insideRight) && !nextLeft(outsideLeft))
+    {
+        m_thread[outsideLeft.index] = nextLeft(insideRight).index;
+        m_mod[outsideLeft.index] += modInsideRight - modOutsideLeft;
+        defaultAncestor = node;
     }
+    return defaultAncestor;
 }
 
-// secondWalk：将 prelim（相对 x）与 m_position 组合，计算最终坐标
-void TreeLayout::secondWalk(TreeNode *node, float modSum)
+void TreeLayout::moveSubtree(FlatNode leftNode, FlatNode rightNode, float shift)
 {
-    if (!node) return;
+    // 中间的兄弟子树按序号均匀分摊平移，实际移动延迟到 executeShifts
+    float subtrees = static_cast<float>(m_number[rightNode.index] - m_number[leftNode.index]);
+    m_change[rightNode.index] -= shift / subtrees;
+    m_shift[rightNode.index] += shift;
+    m_change[leftNode.index] += shift / subtrees;
+    m_prelim[rightNode.index] += shift;
+    m_mod[rightNode.index] += shift;
+}
 
-    float x = m_prelim[node->index] + modSum;
-    float y = node->getDepth() * (m_verticalSpacing + m_nodeHeight);
+void TreeLayout::executeShifts(FlatNode node, std::vector<int> &siblings)
+{
+    // FlatTree 只有向后的兄弟指针，先收集子节点再从右向左累加
+    siblings.clear();
+    for (FlatNode child = node.firstChild(); child; child = child.nextSibling())
+        siblings.push_back(child.index);
+
+    float shift = 0.0f;
+    float change = 0.0f;
+    for (auto it = siblings.rbegin(); it != siblings.rend(); ++it)
+    {
+        int child = *it;
+        m_prelim[child] += shift;
+        m_mod[child] += shift;
+        change += m_change[child];
+        shift += m_shift[child] + change;
+    }
+}
 
-    m_nodePositions[node->index] = sf::Vector2f(m_position.x + x, m_position.y + y);
+void TreeLayout::secondWalk(FlatNode root, float modSum, const std::vector<char> *walked,
+                            const std::vector<int> *runOf, std::vector<float> *runModSums)
+{
+    float levelHeight = m_verticalSpacing + m_nodeHeight;
 
-    for (TreeNode *child : node->children)
+    // 栈中保存节点及其所有祖先的修正值之和
+    std::vector<std::pair<int, float>> stack;
+    stack.emplace_back(root.index, modSum);
+    while (!stack.empty())
     {
-        secondWalk(child, modSum); // modSum is zero in this simple approach (we stored absolute x in prelim)
+        auto [index, modSum] = stack.back();
+        stack.pop_back();
+
+        FlatNode node = m_tree->getFlatNode(index);
+        float x = m_prelim[index] + modSum;
+        float y = node.depth() * levelHeight;
+        m_nodePositions[index] = sf::Vector2f(m_position.x + x, m_position.y + y);
+
+        float childModSum = modSum + m_mod[index];
+        for (FlatNode child = node.firstChild(); child; child = child.nextSibling())
+        {
+            if (walked && (*walked)[child.index])
+            {
+                // 同一段的子树共享父节点，记录一次即可
+                int run = (*runOf)[child.index];
+                if (run >= 0)
+                    (*runModSums)[run] = childModSum;
+                continue;
+            }
+            stack.emplace_back(child.index, childModSum);
+        }
     }
 }
 
@@ -278,14 +690,16 @@ void TreeLayout::normalizePositions()
     if (m_nodePositions.empty()) return;
 
     float minX = std::numeric_limits<float>::max();
-    for (const auto &p : m_nodePositions)
-        minX = std::min(minX, p.x);
+    for (int index = 0; index < static_cast<int>(m_nodePositions.size()); ++index)
+        if (isNodePlaced(index))
+            minX = std::min(minX, m_nodePositions[index].x);
 
-    if (minX < m_position.x)
+    if (minX < m_position.x && minX != std::numeric_limits<float>::max())
     {
         float shift = m_position.x - minX;
-        for (auto &p : m_nodePositions)
-            p.x += shift;
+        for (int index = 0; index < static_cast<int>(m_nodePositions.size()); ++index)
+            if (isNodePlaced(index))
+                m_nodePositions[index].x += shift;
     }
 }
 
@@ -346,137 +760,22 @@ void TreeLayout::calculateAdaptiveParameters()
     m_verticalSpacing = std::max(m_verticalSpacing, m_nodeHeight * 1.5f);
 }
 
-TreeNode *TreeLayout::getLeftSibling(TreeNode *node)
-{
-    if (!node || !node->parent)
-        return nullptr;
-
-    auto &children = node->parent->children;
-    auto it = std::find(children.begin(), children.end(), node);
-    if (it != children.begin())
-    {
-        return *(it - 1);
-    }
-    return nullptr;
-}
-
-TreeNode *TreeLayout::getLeftmostChild(TreeNode *node)
+FlatNode TreeLayout::nextLeft(FlatNode node) const
 {
-    if (!node || node->children.empty())
-        return nullptr;
-    return node->children.front();
+    if (!node.isLeaf()) return node.firstChild();
+    return FlatNode{node.tree, m_thread[node.index]};
 }
 
-TreeNode *TreeLayout::getRightmostChild(TreeNode *node)
+FlatNode TreeLayout::nextRight(FlatNode node) const
 {
-    if (!node || node->children.empty())
-        return nullptr;
-    return node->children.back();
+    if (!node.isLeaf()) return node.lastChild();
+    return FlatNode{node.tree, m_thread[node.index]};
 }
 
-TreeNode *TreeLayout::nextLeft(TreeNode *node)
+FlatNode TreeLayout::getAncestor(FlatNode leftContour, FlatNode node, FlatNode defaultAncestor) const
 {
-    if (!node) return nullptr;
-    if (!node->children.empty()) return node->children.front();
-    if (m_thread[node->index] != -1) 
-    {
-        TreeNode* tnode = m_tree->getNodeByIndex(m_thread[node->index]);
-        if (tnode && tnode->getDepth() > node->getDepth())
-            return tnode;
-    }
-    return nullptr;
-}
-
-TreeNode *TreeLayout::nextRight(TreeNode *node)
-{
-    if (!node) return nullptr;
-    if (!node->children.empty()) return node->children.back();
-    if (m_thread[node->index] != -1) 
-    {
-        TreeNode* tnode = m_tree->getNodeByIndex(m_thread[node->index]);
-        if (tnode && tnode->getDepth() > node->getDepth())
-            return tnode;
-    }
-    return nullptr;
-}
-
-TreeNode *TreeLayout::getAncestor(TreeNode *node, int ancestorIndex)
-{
-    if (!node) return nullptr;
-    // 保守实现：向上查找直到找到 ancestorIndex 或到 root
-    TreeNode *cur = node;
-    while (cur)
-    {
-        if (cur->index == ancestorIndex) return cur;
-        cur = cur->parent;
-    }
-    return nullptr;
-}
-
-float TreeLayout::getSubtreeSeparation(TreeNode *leftNode, TreeNode *rightNode)
-{
-    (void)leftNode;
-    (void)rightNode;
-    return m_horizontalSpacing + m_nodeWidth;
-}
-
-float TreeLayout::getContourConflict(TreeNode *leftNode, TreeNode *rightNode, float shift)
-{
-    // 保留但不在主流程使用（仅作为备份/工具）
-    float distance = 0;
-    TreeNode *leftContour = leftNode;
-    TreeNode *rightContour = rightNode;
-    int level = 0;
-
-    while (leftContour && rightContour)
-    {
-        float leftPos = getRightContour(leftContour, m_mod[leftContour->index], level);
-        float rightPos = getLeftContour(rightContour, m_mod[rightContour->index], level);
-
-        distance = std::max(distance, leftPos - rightPos + shift);
-
-        leftContour = nextRight(leftContour);
-        rightContour = nextLeft(rightContour);
-        level++;
-    }
-
-    return distance;
-}
-
-float TreeLayout::getLeftContour(TreeNode *node, float &minMod, int level)
-{
-    if (!node)
-        return std::numeric_limits<float>::lowest();
-
-    float currentMod = m_mod[node->index];
-    minMod = std::min(minMod, currentMod);
-
-    float position = m_prelim[node->index] + currentMod;
-
-    TreeNode *next = nextLeft(node);
-    if (next)
-    {
-        return std::min(position, getLeftContour(next, minMod, level + 1));
-    }
-
-    return position;
-}
-
-float TreeLayout::getRightContour(TreeNode *node, float &maxMod, int level)
-{
-    if (!node)
-        return std::numeric_limits<float>::max();
-
-    float currentMod = m_mod[node->index];
-    maxMod = std::max(maxMod, currentMod);
-
-    float position = m_prelim[node->index] + currentMod;
-
-    TreeNode *next = nextRight(node);
-    if (next)
-    {
-        return std::max(position, getRightContour(next, maxMod, level + 1));
-    }
-
-    return position;
+    FlatNode ancestor{node.tree, m_ancestor[leftContour.index]};
+    if (ancestor.parent() == node.parent())
+        return ancestor;
+    return defaultAncestor;
 }
@@ -2,9 +2,19 @@
 
 #include "../Core/TreeNode.h"
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
+/**
+ * @brief 布局方式
+ */
+enum class LayoutMode
+{
+    Layered, // 分层布局：每层一行，宽度随叶子数增长
+    Radial   // 径向布局：根在中心，每层一个圆环，半径只随深度增长
+};
+
 /**
  * @brief 树布局器，负责计算树节点的位置
  */
@@ -32,11 +42,79 @@ public:
     void setLayoutParameters(float horizontalSpacing = 200.0f, float verticalSpacing = 150.0f,
                              float nodeWidth = 80.0f, float nodeHeight = 80.0f);
 
+    /**
+     * @brief 设置布局方式（下次calculateLayout时生效）
+     * @param mode 布局方式
+     */
+    void setLayoutMode(LayoutMode mode);
+
+    /**
+     * @brief 获取布局方式
+     */
+    LayoutMode getLayoutMode() const;
+
+    /**
+     * @brief 设置布局使用的线程数
+     * @param threadCount 线程数（0表示使用硬件并发数，1表示串行）
+     */
+    void setThreadCount(unsigned threadCount);
+
     /**
      * @brief 计算布局
+     *
+     * 节点较多时把树切分为互不相交的子树，多线程分别完成第一遍和第二遍遍历，
+     * 子树之上的部分串行合并兄弟轮廓；结果与串行布局逐位相同
      */
     void calculateLayout();
 
+    /**
+     * @brief 直接使用已计算好的节点位置（例如从布局缓存读取），不重新计算布局
+     * @param positions 按节点索引排列的位置
+     * @param count 位置数量（应等于树的大小）
+     */
+    void setNodePositions(const sf::Vector2f *positions, size_t count);
+
+    /**
+     * @brief 开始增量布局：清空所有位置，之后只为逐个显示的节点计算位置
+     *
+     * 画布只随已显示的节点增长，不再按整棵树的最终尺寸展开
+     */
+    void beginIncrementalLayout();
+
+    /**
+     * @brief 增量放置一个新显示的节点（尚未放置的祖先一并放置）
+     *
+     * 新节点放在所在层最右节点的右侧，第一个子节点尽量放在父节点正下方；
+     * 随后沿到根的路径把祖先右移到首末子节点的中点，祖先不需移动或右侧已有同层节点时停止。
+     * 每次耗时O(深度)，已放置的节点再次显示时不做任何事
+     * @param nodeIndex 节点索引
+     */
+    void revealNode(int nodeIndex);
+
+    /**
+     * @brief 是否处于增量布局模式
+     */
+    bool isIncremental() const;
+
+    /**
+     * @brief 节点是否已有位置（整体布局时为所有已布局的节点，增量布局时为已放置的节点；DAG中合并掉的索引没有位置）
+     * @param nodeIndex 节点索引
+     */
+    bool isNodePlaced(int nodeIndex) const;
+
+    /**
+     * @brief 位置版本号，整体重新布局（calculateLayout、setNodePositions、beginIncrementalLayout）时递增，
+     * 渲染器据此判断空间索引是否需要整体重建；增量放置不改变版本号，见getIncrementalChanges
+     */
+    uint64_t getRevision() const;
+
+    /**
+     * @brief 本次增量布局中放置或移动过的节点，按发生顺序追加（同一节点可能出现多次）
+     *
+     * 版本号不变时调用方只需处理上次读取之后追加的部分，整体布局时为空
+     */
+    const std::vector<int> &getIncrementalChanges() const { return m_changedNodes; }
+
     /**
      * @brief 获取节点位置
      * @param nodeIndex 节点索引
@@ -73,162 +151,115 @@ private:
     float m_nodeHeight;        // 节点高度
     sf::Vector2f m_position;   // 位置偏移
 
-    // Reingold-Tilford 算法相关
-    std::vector<float> m_mod;    // 节点修正值
-    std::vector<float> m_prelim; // 节点初步X坐标
-    std::vector<float> m_shift;  // 节点偏移量
-    std::vector<float> m_change; // 节点变化量
-    std::vector<int> m_thread;   // 线程指针
-    std::vector<int> m_ancestor; // 祖先节点
+    // Buchheim-Walker 算法工作列（按节点索引）
+    std::vector<float> m_mod;      // 节点修正值（第二遍累加到所有后代）
+    std::vector<float> m_prelim;   // 节点初步X坐标（相对父节点的修正值链）
+    std::vector<float> m_shift;    // 节点子树待执行的平移量
+    std::vector<float> m_change;   // 平移量在兄弟间的每步变化量
+    std::vector<int> m_thread;     // 线程指针（轮廓在叶子处延伸到更深的层）
+    std::vector<int> m_ancestor;   // 祖先节点（右轮廓节点所属的兄弟子树根）
+    std::vector<int> m_number;     // 节点在兄弟中的序号
+    unsigned m_threadCount;        // 布局线程数（0表示硬件并发数）
+    LayoutMode m_layoutMode;       // 布局方式
+    uint64_t m_revision;           // 位置版本号
 
-    // 稳定布局算法相关
-    float m_nextX;              // 中序遍历当前x位置
-    float m_inorderStep;        // 中序遍历步长
+    // 增量布局相关
+    bool m_incremental;                  // 是否处于增量布局模式
+    std::vector<char> m_placed;          // 节点是否已放置
+    std::vector<int> m_firstPlacedChild; // 第一个已放置的子节点
+    std::vector<int> m_lastPlacedChild;  // 最后一个已放置的子节点
+    std::vector<int> m_levelLast;        // 每层最右的已放置节点
+    std::vector<int> m_changedNodes;     // 放置或移动过的节点（按发生顺序）
 
     /**
-     * @brief 执行稳定布局算法
+     * @brief 放置单个节点（父节点须已放置）并沿祖先路径重新居中
+     * @param node 节点
      */
-    void executeStableLayout();
+    void placeIncremental(FlatNode node);
 
     /**
-     * @brief 中序遍历分配初步位置
-     * @param node 当前节点
-     */
-    void assignPrelimInorder(TreeNode *node);
-
-    /**
-     * @brief 收集子树轮廓
-     * @param node 当前节点
-     * @param prelim 初步位置数组
-     * @param minAtDepth 每层最小x
-     * @param maxAtDepth 每层最大x
-     * @param depth 当前深度
-     */
-    void collectContours(TreeNode *node, const std::vector<float> &prelim, std::vector<float> &minAtDepth, std::vector<float> &maxAtDepth, int depth);
-
-    /**
-     * @brief 移动子树
-     * @param node 子树根节点
-     * @param shift 移动距离
-     */
-    void shiftSubtree(TreeNode *node, float shift);
-
-    /**
-     * @brief 递归解决冲突
-     * @param node 当前节点
-     */
-    void resolveConflictsRec(TreeNode *node);
-
-    /**
-     * @brief 执行Reingold-Tilford树布局算法
+     * @brief 执行Buchheim-Walker树布局算法（线性时间的Reingold-Tilford）
      */
     void executeReingoldTilford();
 
     /**
-     * @brief 第一次遍历：计算初步位置
-     * @param node 当前节点
-     * @param level 当前层级
+     * @brief 执行径向布局
+     *
+     * 一次逆先序累加每个子树的叶子数，再一次先序把父节点的角度区间按叶子数分给子节点，
+     * 节点放在所在深度圆环上自身区间的中点，总耗时O(N)
      */
-    void firstWalk(TreeNode *node, int level);
+    void executeRadialLayout();
 
     /**
-     * @brief 第二次遍历：计算最终位置
-     * @param node 当前节点
-     * @param modSum 修正值总和
+     * @brief 并行执行两遍遍历
+     * @param root 根节点
+     * @param threadCount 线程数
+     * @return 树太小不值得并行时返回false，此时未做任何计算
      */
-    void secondWalk(TreeNode *node, float modSum);
+    bool executeParallel(FlatNode root, unsigned threadCount);
 
     /**
-     * @brief 获取节点的左兄弟
-     * @param node 当前节点
-     * @return 左兄弟节点，如果没有返回nullptr
+     * @brief 第一次遍历：后序计算所有节点的初步位置和修正值（显式栈，不受树深度限制）
+     * @param root 子树根节点（按没有左兄弟放置）
+     * @param walked 已由其他任务完成第一遍的子树根标记，这些子树只放置根节点并与左兄弟分配；为空表示没有
      */
-    TreeNode *getLeftSibling(TreeNode *node);
+    void firstWalk(FlatNode root, const std::vector<char> *walked);
 
     /**
-     * @brief 获取节点的最左子节点
+     * @brief 按已计算的左兄弟放置节点：叶子紧挨左兄弟，内部节点居中于首末子节点之上
      * @param node 当前节点
-     * @return 最左子节点
+     * @param leftSibling 左兄弟，没有时为空句柄
      */
-    TreeNode *getLeftmostChild(TreeNode *node);
+    void placeNode(FlatNode node, FlatNode leftSibling);
 
     /**
-     * @brief 获取节点的最右子节点
-     * @param node 当前节点
-     * @return 最右子节点
+     * @brief 第二次遍历：累加修正值计算最终位置（显式栈）
+     * @param root 子树根节点
+     * @param modSum root所有祖先的修正值之和
+     * @param walked 由其他任务负责的子树根标记，遇到时不进入；为空表示没有
+     * @param runOf 每段兄弟子树中第一个子树根对应的段号，其余为-1
+     * @param runModSums 输出：每段兄弟子树的祖先修正值之和
      */
-    TreeNode *getRightmostChild(TreeNode *node);
+    void secondWalk(FlatNode root, float modSum, const std::vector<char> *walked,
+                    const std::vector<int> *runOf, std::vector<float> *runModSums);
 
     /**
      * @brief 获取节点的下一个左轮廓节点
      * @param node 当前节点
      * @return 下一个左轮廓节点
      */
-    TreeNode *nextLeft(TreeNode *node);
+    FlatNode nextLeft(FlatNode node) const;
 
     /**
      * @brief 获取节点的下一个右轮廓节点
      * @param node 当前节点
      * @return 下一个右轮廓节点
      */
-    TreeNode *nextRight(TreeNode *node);
+    FlatNode nextRight(FlatNode node) const;
 
     /**
-     * @brief 移动子树
-     * @param ancestorNode 祖先节点
-     * @param node 当前节点
+     * @brief 移动子树，夹在两者之间的兄弟子树通过shift/change均匀分摊
+     * @param leftNode 冲突中左侧的兄弟子树根
+     * @param rightNode 需要右移的子树根
      * @param shift 移动距离
      */
-    void moveSubtree(TreeNode *ancestorNode, TreeNode *node, float shift);
-
-    /**
-     * @brief 执行移动
-     * @param node 当前节点
-     */
-    void executeShifts(TreeNode *node);
-
-    /**
-     * @brief 获取指定祖先的节点
-     * @param node 当前节点
-     * @param ancestorIndex 祖先索引
-     * @return 具有指定祖先的节点
-     */
-    TreeNode *getAncestor(TreeNode *node, int ancestorIndex);
+    void moveSubtree(FlatNode leftNode, FlatNode rightNode, float shift);
 
     /**
-     * @brief 计算子树分离
-     * @param leftNode 左节点
-     * @param rightNode 右节点
-     * @return 需要的分离距离
-     */
-    float getSubtreeSeparation(TreeNode *leftNode, TreeNode *rightNode);
-
-    /**
-     * @brief 计算轮廓冲突
-     * @param leftNode 左节点
-     * @param rightNode 右节点
-     * @param shift 当前偏移
-     * @return 需要的额外偏移
-     */
-    float getContourConflict(TreeNode *leftNode, TreeNode *rightNode, float shift);
-
-    /**
-     * @brief 获取左轮廓
+     * @brief 执行子节点上累计的移动
      * @param node 当前节点
-     * @param maxMod 最大修正值
-     * @param level 层级
-     * @return 左轮廓位置
+     * @param siblings 倒序遍历子节点用的临时列（每个线程各自一份）
      */
-    float getLeftContour(TreeNode *node, float &maxMod, int level);
+    void executeShifts(FlatNode node, std::vector<int> &siblings);
 
     /**
-     * @brief 获取右轮廓
+     * @brief 获取左轮廓节点所属的兄弟子树根
+     * @param leftContour 左子树森林的右轮廓节点
      * @param node 当前节点
-     * @param minMod 最小修正值
-     * @param level 层级
-     * @return 右轮廓位置
+     * @param defaultAncestor 默认祖先
+     * @return 与node同父的祖先节点，否则返回defaultAncestor
      */
-    float getRightContour(TreeNode *node, float &minMod, int level);
+    FlatNode getAncestor(FlatNode leftContour, FlatNode node, FlatNode defaultAncestor) const;
 
     /**
      * @brief 计算自适应参数（根据树大小调整节点尺寸和间距）
@@ -241,16 +272,12 @@ private:
     void normalizePositions();
 
     /**
-     * @brief 子树分配算法
+     * @brief 子树分配算法：沿轮廓把node子树与左侧兄弟子树分开
      * @param node 当前节点
-     * @param level 层级
-     */
-    void apportion(TreeNode *node, int level);
-
-    /**
-     * @brief 计算子树大小
-     * @param node 根节点
-     * @return 子树节点数量
+     * @param leftSibling 左兄弟
+     * @param leftmostSibling 最左兄弟
+     * @param defaultAncestor 默认祖先
+     * @return 新的默认祖先
      */
-    int calculateSubtreeSize(TreeNode *node);
+    FlatNode apportion(FlatNode node, FlatNode leftSibling, FlatNode leftmostSibling, FlatNode defaultAncestor);
 };
@@ -1,8 +1,19 @@
 #include "TreeRenderer.h"
 #include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    // 增量布局中动态桶至少容纳这么多条目才整体重建空间索引
+    constexpr size_t MIN_DYNAMIC_ITEMS = 4096;
+}
 
 TreeRenderer::TreeRenderer()
-    : m_tree(nullptr), m_layout(nullptr), m_displayManager(nullptr), m_connectionColor(sf::Color::White), m_connectionWidth(2.0f)
+    : m_tree(nullptr), m_layout(nullptr), m_displayManager(nullptr), m_connectionColor(sf::Color::White), m_mergedEdgeColor(255, 140, 0), m_chainEdgeColor(100, 180, 255), m_connectionWidth(2.0f),
+      m_compression(nullptr), m_fontLoaded(false), m_indexedLayout(nullptr), m_indexedRevision(0),
+      m_indexedChanges(0), m_boardVertices(sf::Triangles)
 {
 }
 
@@ -10,6 +21,7 @@ void TreeRenderer::setTreeAndLayout(Tree *tree, TreeLayout *layout)
 {
     m_tree = tree;
     m_layout = layout;
+    m_indexedLayout = nullptr;
 }
 
 void TreeRenderer::setBoardRenderer(std::unique_ptr<BoardRenderer> renderer)
@@ -24,12 +36,24 @@ void TreeRenderer::draw(sf::RenderWindow &window)
         return;
     }
 
+    // 只取与当前视图相交的节点和连接线，视图外的部分不参与本帧绘制
+    updateSpatialIndex();
+    const sf::View &view = window.getView();
+    float margin = getQueryMargin();
+    sf::FloatRect area(view.getCenter() - view.getSize() / 2.0f - sf::Vector2f(margin, margin),
+                       view.getSize() + sf::Vector2f(2 * margin, 2 * margin));
+    m_nodeIndex.query(area, m_nodesInView);
+    m_edgeIndex.query(area, m_edgesInView);
+
     // 绘制连接线
     drawConnections(window);
 
     // 绘制高亮路径
     drawHighlightPath(window);
 
+    // 绘制折叠单链的链长标记
+    drawChainBadges(window);
+
     // 绘制节点
     drawNodes(window);
 }
@@ -47,11 +71,23 @@ void TreeRenderer::setConnectionWidth(float width)
 void TreeRenderer::setHighlightPath(const std::vector<int> &path)
 {
     m_highlightPath = path;
+
+    // 按索引标记路径上的节点，绘制时逐节点判断为O(1)
+    m_inHighlight.clear();
+    for (int index : m_highlightPath)
+    {
+        if (index >= static_cast<int>(m_inHighlight.size()))
+        {
+            m_inHighlight.resize(index + 1, 0);
+        }
+        m_inHighlight[index] = 1;
+    }
 }
 
 void TreeRenderer::clearHighlightPath()
 {
     m_highlightPath.clear();
+    m_inHighlight.clear();
 }
 
 void TreeRenderer::setDisplayManager(DisplayManager *displayManager)
@@ -64,55 +100,144 @@ DisplayManager *TreeRenderer::getDisplayManager() const
     return m_displayManager;
 }
 
-void TreeRenderer::drawConnections(sf::RenderWindow &window)
+void TreeRenderer::setChainCompression(const CompressedSolution *compression)
 {
-    if (!m_tree || !m_layout || !m_boardRenderer)
+    m_compression = compression;
+
+    // 只有折叠视图用到文字，第一次使用时才加载字体
+    if (m_compression && !m_fontLoaded)
     {
-        return;
+        m_fontLoaded = m_font.loadFromFile("C:/Windows/Fonts/arial.ttf");
+        if (!m_fontLoaded)
+        {
+            std::cerr << "警告: 无法加载字体，链长标记将不显示文本" << std::endl;
+        }
     }
+}
 
-    // 创建连接线
-    sf::VertexArray lines(sf::Lines, 0);
+int TreeRenderer::findChainBadge(const sf::Vector2f &worldPos)
+{
+    if (!m_tree || !m_layout || !m_compression || !m_boardRenderer)
+    {
+        return -1;
+    }
 
-    const auto &allNodes = m_tree->getAllNodes();
-    for (TreeNode *node : allNodes)
+    // 标记在边的中点附近，只需检查点击位置附近的边
+    updateSpatialIndex();
+    float margin = getQueryMargin();
+    std::vector<int> edges;
+    m_edgeIndex.query(sf::FloatRect(worldPos.x - margin, worldPos.y - margin, 2 * margin, 2 * margin), edges);
+    for (int edge : edges)
     {
-        if (!node || node->isRoot())
+        const IndexedEdge &indexed = m_edges[edge];
+        if (indexed.merged || m_compression->hiddenCount(indexed.to) == 0 || !isEdgeVisible(indexed.from, indexed.to))
         {
             continue;
         }
+        if (getChainBadgeBounds(indexed.to).contains(worldPos))
+        {
+            return indexed.to;
+        }
+    }
+    return -1;
+}
 
-        // 检查父节点和当前节点是否都可见（如果有显示管理器）
-        if (m_displayManager)
+bool TreeRenderer::isEdgeVisible(int parentIndex, int index) const
+{
+    return !m_displayManager ||
+           (m_displayManager->isNodeVisible(parentIndex) && m_displayManager->isNodeVisible(index));
+}
+
+sf::FloatRect TreeRenderer::getChainBadgeBounds(int index) const
+{
+    // 标记放在两端棋盘中心连线的中点，宽度随链长的位数增加
+    sf::Vector2f boardSize = m_boardRenderer->getTotalSize();
+    sf::Vector2f parentCenter = m_layout->getNodePosition(m_tree->getFlatTree().parent(index)) + boardSize / 2.0f;
+    sf::Vector2f center = m_layout->getNodePosition(index) + boardSize / 2.0f;
+    sf::Vector2f middle = (parentCenter + center) / 2.0f;
+
+    float height = boardSize.y * 0.2f;
+    float width = height * (0.6f + 0.5f * std::to_string(m_compression->hiddenCount(index)).size());
+    return sf::FloatRect(middle.x - width / 2.0f, middle.y - height / 2.0f, width, height);
+}
+
+void TreeRenderer::drawChainBadges(sf::RenderWindow &window)
+{
+    if (!m_compression)
+    {
+        return;
+    }
+
+    for (int edge : m_edgesInView)
+    {
+        const IndexedEdge &indexed = m_edges[edge];
+        int hidden = indexed.merged ? 0 : m_compression->hiddenCount(indexed.to);
+        if (hidden == 0 || !isEdgeVisible(indexed.from, indexed.to))
         {
-            if (!m_displayManager->isNodeVisible(node->parent->index) ||
-                !m_displayManager->isNodeVisible(node->index))
-            {
-                continue;
-            }
+            continue;
         }
 
-        // 获取父节点和当前节点的位置
-        sf::Vector2f parentPos = m_layout->getNodePosition(node->parent->index);
-        sf::Vector2f currentPos = m_layout->getNodePosition(node->index);
+        sf::FloatRect bounds = getChainBadgeBounds(indexed.to);
+        sf::RectangleShape badge(sf::Vector2f(bounds.width, bounds.height));
+        badge.setPosition(bounds.left, bounds.top);
+        badge.setFillColor(sf::Color(30, 30, 30));
+        badge.setOutlineColor(m_chainEdgeColor);
+        badge.setOutlineThickness(2.0f);
+        window.draw(badge);
 
-        // 获取BoardRenderer的实际大小
-        sf::Vector2f boardSize = m_boardRenderer->getTotalSize();
+        if (m_fontLoaded)
+        {
+            sf::Text text;
+            text.setFont(m_font);
+            text.setString("+" + std::to_string(hidden));
+            text.setCharacterSize(static_cast<unsigned int>(bounds.height * 0.7f));
+            text.setFillColor(m_chainEdgeColor);
+            sf::FloatRect textRect = text.getLocalBounds();
+            text.setOrigin(textRect.left + textRect.width / 2.0f, textRect.top + textRect.height / 2.0f);
+            text.setPosition(bounds.left + bounds.width / 2.0f, bounds.top + bounds.height / 2.0f);
+            window.draw(text);
+        }
+    }
+}
+
+void TreeRenderer::drawConnections(sf::RenderWindow &window)
+{
+    if (!m_tree || !m_layout || !m_boardRenderer)
+    {
+        return;
+    }
 
-        // 调整连接点位置，从父节点底部中点连接到子节点顶部中点
-        parentPos.x += boardSize.x / 2; // 父节点底部中点
-        parentPos.y += boardSize.y;     // 从父节点底部
+    // 树边和合并边分开收集，合并边画在树边之上
+    sf::VertexArray lines(sf::Lines, 0);
+    sf::VertexArray mergedLines(sf::Lines, 0);
 
-        currentPos.x += boardSize.x / 2; // 子节点顶部中点
-        currentPos.y -= 5;               // 从子节点顶部稍微向上偏移，避免重叠
+    // 视图中的连接线两端都可见时才绘制（如果有显示管理器）
+    for (int edge : m_edgesInView)
+    {
+        const IndexedEdge &indexed = m_edges[edge];
+        if (!isEdgeVisible(indexed.from, indexed.to))
+        {
+            continue;
+        }
+
+        sf::Vector2f start, end;
+        getEdgeEndpoints(indexed.from, indexed.to, start, end);
+        if (indexed.merged)
+        {
+            mergedLines.append(sf::Vertex(start, m_mergedEdgeColor));
+            mergedLines.append(sf::Vertex(end, m_mergedEdgeColor));
+            continue;
+        }
 
-        // 添加连接线
-        lines.append(sf::Vertex(parentPos, m_connectionColor));
-        lines.append(sf::Vertex(currentPos, m_connectionColor));
+        bool collapsed = m_compression && m_compression->hiddenCount(indexed.to) > 0;
+        sf::Color color = collapsed ? m_chainEdgeColor : m_connectionColor;
+        lines.append(sf::Vertex(start, color));
+        lines.append(sf::Vertex(end, color));
     }
 
     // 绘制所有连接线
     window.draw(lines);
+    window.draw(mergedLines);
 }
 
 void TreeRenderer::drawNodes(sf::RenderWindow &window)
@@ -122,73 +247,46 @@ void TreeRenderer::drawNodes(sf::RenderWindow &window)
         return;
     }
 
-    const auto &allNodes = m_tree->getAllNodes();
-    
-    // 分离高亮节点和非高亮节点
-    std::vector<TreeNode*> normalNodes;
-    std::vector<TreeNode*> highlightNodes;
+    // 分离视图中的高亮节点和非高亮节点
+    std::vector<int> normalNodes;
+    std::vector<int> highlightNodes;
 
-    for (TreeNode *node : allNodes)
+    for (int index : m_nodesInView)
     {
-        if (!node)
-        {
-            continue;
-        }
-
         // 检查节点是否可见（如果有显示管理器）
-        if (m_displayManager && !m_displayManager->isNodeVisible(node->index))
+        if (m_displayManager && !m_displayManager->isNodeVisible(index))
         {
             continue;
         }
 
         // 判断节点是否在高亮路径中
-        if (isNodeInHighlightPath(node->index))
+        if (isNodeInHighlightPath(index))
         {
-            highlightNodes.push_back(node);
+            highlightNodes.push_back(index);
         }
         else
         {
-            normalNodes.push_back(node);
+            normalNodes.push_back(index);
         }
     }
 
-    // 先绘制非高亮节点
-    for (TreeNode *node : normalNodes)
-    {
-        // 获取节点位置
-        sf::Vector2f position = m_layout->getNodePosition(node->index);
-
-        // 设置BoardRenderer的位置
-        m_boardRenderer->setPosition(position.x, position.y);
-
-        // 绘制棋盘
-        m_boardRenderer->draw(window, node->state);
-
-        // 设置数值显示
-        m_boardRenderer->setValues(node->g, node->h, node->f);
-    }
+    // 高亮节点排在最后（确保在最前方）
+    size_t normalCount = normalNodes.size();
+    normalNodes.insert(normalNodes.end(), highlightNodes.begin(), highlightNodes.end());
 
-    // 最后绘制高亮节点（确保在最前方）
-    for (TreeNode *node : highlightNodes)
+    // 所有棋盘的矩形、数字和数值面板文字追加到同一个顶点数组，以字形图集为纹理一次绘制
+    m_boardVertices.clear();
+    for (size_t i = 0; i < normalNodes.size(); ++i)
     {
-        // 获取节点位置
-        sf::Vector2f position = m_layout->getNodePosition(node->index);
-
-        // 设置BoardRenderer的位置
+        int index = normalNodes[i];
+        sf::Vector2f position = m_layout->getNodePosition(index);
         m_boardRenderer->setPosition(position.x, position.y);
-
-        // 为高亮节点添加边框
-        m_boardRenderer->setHighlightBorder(true);
-
-        // 绘制棋盘
-        m_boardRenderer->draw(window, node->state);
-
-        // 设置数值显示
-        m_boardRenderer->setValues(node->g, node->h, node->f);
-
-        // 重置边框设置
-        m_boardRenderer->setHighlightBorder(false);
+        m_boardRenderer->setValues(m_tree->getG(index), m_tree->getH(index), m_tree->getF(index));
+        m_boardRenderer->setHighlightBorder(i >= normalCount);
+        m_boardRenderer->appendBoard(m_boardVertices, m_tree->getState(index));
     }
+    window.draw(m_boardVertices, &m_boardRenderer->getTexture());
+    m_boardRenderer->setHighlightBorder(false);
 }
 
 void TreeRenderer::drawHighlightPath(sf::RenderWindow &window)
@@ -201,9 +299,6 @@ void TreeRenderer::drawHighlightPath(sf::RenderWindow &window)
     // 创建高亮路径的连接线
     sf::VertexArray highlightLines(sf::Lines, 0);
 
-    // 获取BoardRenderer的实际大小
-    sf::Vector2f boardSize = m_boardRenderer->getTotalSize();
-
     for (size_t i = 0; i < m_highlightPath.size() - 1; ++i)
     {
         int currentIndex = m_highlightPath[i];
@@ -227,16 +322,9 @@ void TreeRenderer::drawHighlightPath(sf::RenderWindow &window)
             }
         }
 
-        // 获取节点位置
-        sf::Vector2f currentPos = m_layout->getNodePosition(currentIndex);
-        sf::Vector2f nextPos = m_layout->getNodePosition(nextIndex);
-
-        // 调整连接点位置，从当前节点底部中点连接到下一个节点顶部中点
-        currentPos.x += boardSize.x / 2; // 当前节点底部中点
-        currentPos.y += boardSize.y;     // 从当前节点底部
-
-        nextPos.x += boardSize.x / 2; // 下一个节点顶部中点
-        nextPos.y -= 5;               // 从下一个节点顶部稍微向上偏移，避免重叠
+        // 从当前节点连接到下一个节点
+        sf::Vector2f currentPos, nextPos;
+        getEdgeEndpoints(currentIndex, nextIndex, currentPos, nextPos);
 
         // 添加高亮连接线（使用黄色）
         highlightLines.append(sf::Vertex(currentPos, sf::Color::Yellow));
@@ -247,7 +335,7 @@ void TreeRenderer::drawHighlightPath(sf::RenderWindow &window)
     window.draw(highlightLines);
 }
 
-sf::Color TreeRenderer::getNodeColor(TreeNode *node) const
+sf::Color TreeRenderer::getNodeColor(FlatNode node) const
 {
     if (!node)
     {
@@ -255,18 +343,18 @@ sf::Color TreeRenderer::getNodeColor(TreeNode *node) const
     }
 
     // 根据节点是否在高亮路径中返回不同颜色
-    if (isNodeInHighlightPath(node->index))
+    if (isNodeInHighlightPath(node.index))
     {
         return sf::Color::Yellow; // 高亮路径中的节点使用黄色
     }
 
     // 根据节点深度返回不同颜色（可选功能）
-    int depth = node->getDepth();
+    int depth = node.depth();
     if (depth == 0)
     {
         return sf::Color::Green; // 根节点使用绿色
     }
-    else if (node->isLeaf())
+    else if (node.isLeaf())
     {
         return sf::Color::Red; // 叶子节点使用红色
     }
@@ -278,7 +366,7 @@ sf::Color TreeRenderer::getNodeColor(TreeNode *node) const
 
 bool TreeRenderer::isNodeInHighlightPath(int nodeIndex) const
 {
-    return std::find(m_highlightPath.begin(), m_highlightPath.end(), nodeIndex) != m_highlightPath.end();
+    return nodeIndex >= 0 && nodeIndex < static_cast<int>(m_inHighlight.size()) && m_inHighlight[nodeIndex];
 }
 
 sf::Vector2f TreeRenderer::getCurrentNodePosition() const
@@ -288,24 +376,9 @@ sf::Vector2f TreeRenderer::getCurrentNodePosition() const
         return sf::Vector2f(0, 0);
     }
 
-    // 获取当前显示的最后一个节点
-    const auto& visibleNodes = m_displayManager->getVisibleNodes();
-    if (visibleNodes.empty())
-    {
-        return sf::Vector2f(0, 0);
-    }
-
-    // 找到最大的索引（通常是最后显示的节点）
-    int maxIndex = -1;
-    for (int index : visibleNodes)
-    {
-        if (index > maxIndex)
-        {
-            maxIndex = index;
-        }
-    }
-
-    if (maxIndex == -1)
+    // 节点按索引顺序显示，最后显示的节点索引为显示数量减一（每帧O(1)，不遍历可见集合）
+    int maxIndex = static_cast<int>(m_displayManager->getVisibleCount()) - 1;
+    if (maxIndex < 0)
     {
         return sf::Vector2f(0, 0);
     }
@@ -323,3 +396,179 @@ sf::Vector2f TreeRenderer::getCurrentNodePosition() const
 
     return position;
 }
+
+void TreeRenderer::updateSpatialIndex()
+{
+    if (m_indexedLayout == m_layout && m_indexedRevision == m_layout->getRevision())
+    {
+        // 同一次增量布局中只并入之后放置或移动的节点；动态桶超过已索引条目的1/8后整体重建，均摊O(1)
+        const std::vector<int> &changes = m_layout->getIncrementalChanges();
+        if (m_indexedChanges >= changes.size())
+        {
+            return;
+        }
+        size_t dynamicLimit = std::max(MIN_DYNAMIC_ITEMS, (m_nodeIndex.size() + m_edgeIndex.size()) / 8);
+        if (m_nodeIndex.dynamicSize() + m_edgeIndex.dynamicSize() < dynamicLimit)
+        {
+            for (size_t i = m_indexedChanges; i < changes.size(); ++i)
+            {
+                reindexNode(changes[i]);
+            }
+            m_indexedChanges = changes.size();
+            return;
+        }
+    }
+
+    m_nodeIndex.clear();
+    m_edgeIndex.clear();
+    m_edges.clear();
+
+    // 增量布局中尚未放置的节点没有位置，不进入索引
+    sf::Vector2f boardSize = m_boardRenderer->getTotalSize();
+    const FlatTree &flat = m_tree->getFlatTree();
+    int nodeCount = static_cast<int>(flat.size());
+    m_nodeItems.assign(nodeCount, -1);
+    m_parentEdgeItems.assign(nodeCount, -1);
+    for (int index = 0; index < nodeCount; ++index)
+    {
+        if (!flat.contains(index) || !m_layout->isNodePlaced(index))
+        {
+            continue;
+        }
+        m_nodeItems[index] = m_nodeIndex.insert(index, sf::FloatRect(m_layout->getNodePosition(index), boardSize));
+
+        int parent = flat.parent(index);
+        if (parent != FlatTree::NONE && m_layout->isNodePlaced(parent))
+        {
+            indexEdge(parent, index, false, m_parentEdgeItems[index]);
+        }
+    }
+
+    // DAG视图中合并重复状态后多出的边，按端点分组以便增量布局移动节点时找到它们
+    const auto &mergedEdges = m_tree->getMergedEdges();
+    m_mergedEdgeItems.assign(mergedEdges.size(), -1);
+    m_mergedEdgeStart.assign(mergedEdges.empty() ? 0 : nodeCount + 1, 0);
+    m_mergedEdgeList.resize(2 * mergedEdges.size());
+    for (const auto &[from, to] : mergedEdges)
+    {
+        ++m_mergedEdgeStart[from + 1];
+        ++m_mergedEdgeStart[to + 1];
+    }
+    for (size_t node = 1; node < m_mergedEdgeStart.size(); ++node)
+    {
+        m_mergedEdgeStart[node] += m_mergedEdgeStart[node - 1];
+    }
+    std::vector<int> fill(m_mergedEdgeStart);
+    for (size_t edge = 0; edge < mergedEdges.size(); ++edge)
+    {
+        auto [from, to] = mergedEdges[edge];
+        m_mergedEdgeList[fill[from]++] = static_cast<int>(edge);
+        m_mergedEdgeList[fill[to]++] = static_cast<int>(edge);
+        if (m_layout->isNodePlaced(from) && m_layout->isNodePlaced(to))
+        {
+            indexEdge(from, to, true, m_mergedEdgeItems[edge]);
+        }
+    }
+
+    // 格子边长取两个棋盘大小，屏幕大小的视图只覆盖几十个格子
+    float cellSize = 2.0f * std::max(boardSize.x, boardSize.y);
+    m_nodeIndex.build(cellSize);
+    m_edgeIndex.build(cellSize);
+
+    m_indexedLayout = m_layout;
+    m_indexedRevision = m_layout->getRevision();
+    m_indexedChanges = m_layout->getIncrementalChanges().size();
+}
+
+void TreeRenderer::reindexNode(int index)
+{
+    const FlatTree &flat = m_tree->getFlatTree();
+    if (!flat.contains(index) || !m_layout->isNodePlaced(index))
+    {
+        return;
+    }
+
+    // 流式加载时树在增量布局期间继续增长
+    if (m_nodeItems.size() < flat.size())
+    {
+        m_nodeItems.resize(flat.size(), -1);
+        m_parentEdgeItems.resize(flat.size(), -1);
+    }
+    if (m_nodeItems[index] >= 0)
+    {
+        m_nodeIndex.remove(m_nodeItems[index]);
+    }
+    m_nodeItems[index] = m_nodeIndex.insert(index, sf::FloatRect(m_layout->getNodePosition(index),
+                                                                 m_boardRenderer->getTotalSize()));
+
+    // 与该节点相连的连接线随之更新：到父节点的边、到已放置子节点的边和合并边
+    int parent = flat.parent(index);
+    if (parent != FlatTree::NONE && m_layout->isNodePlaced(parent))
+    {
+        indexEdge(parent, index, false, m_parentEdgeItems[index]);
+    }
+    for (int child = flat.firstChild(index); child != FlatTree::NONE; child = flat.nextSibling(child))
+    {
+        if (m_layout->isNodePlaced(child))
+        {
+            indexEdge(index, child, false, m_parentEdgeItems[child]);
+        }
+    }
+    if (static_cast<size_t>(index) + 1 < m_mergedEdgeStart.size())
+    {
+        const auto &mergedEdges = m_tree->getMergedEdges();
+        for (int k = m_mergedEdgeStart[index]; k < m_mergedEdgeStart[index + 1]; ++k)
+        {
+            int edge = m_mergedEdgeList[k];
+            auto [from, to] = mergedEdges[edge];
+            if (m_layout->isNodePlaced(from) && m_layout->isNodePlaced(to))
+            {
+                indexEdge(from, to, true, m_mergedEdgeItems[edge]);
+            }
+        }
+    }
+}
+
+void TreeRenderer::indexEdge(int from, int to, bool merged, int &item)
+{
+    if (item >= 0)
+    {
+        m_edgeIndex.remove(item);
+    }
+
+    // 连接线的范围是两个端点围成的矩形（竖直或水平的线宽或高为0）
+    sf::Vector2f start, end;
+    getEdgeEndpoints(from, to, start, end);
+    sf::FloatRect box(std::min(start.x, end.x), std::min(start.y, end.y),
+                      std::abs(end.x - start.x), std::abs(end.y - start.y));
+    item = m_edgeIndex.insert(static_cast<int>(m_edges.size()), box);
+    m_edges.push_back({from, to, merged});
+}
+
+void TreeRenderer::getEdgeEndpoints(int from, int to, sf::Vector2f &start, sf::Vector2f &end) const
+{
+    sf::Vector2f boardSize = m_boardRenderer->getTotalSize();
+    start = m_layout->getNodePosition(from);
+    end = m_layout->getNodePosition(to);
+
+    if (m_layout->getLayoutMode() == LayoutMode::Radial)
+    {
+        start += boardSize / 2.0f;
+        end += boardSize / 2.0f;
+    }
+    else
+    {
+        start.x += boardSize.x / 2; // 上端节点底部中点
+        start.y += boardSize.y;     // 从上端节点底部
+
+        end.x += boardSize.x / 2; // 下端节点顶部中点
+        end.y -= 5;               // 从下端节点顶部稍微向上偏移，避免重叠
+    }
+}
+
+float TreeRenderer::getQueryMargin() const
+{
+    // 链长标记宽度约为棋盘高度的一半到四分之三，高亮边框只有几个像素
+    sf::Vector2f boardSize = m_boardRenderer->getTotalSize();
+    return 0.5f * std::max(boardSize.x, boardSize.y);
+}
@@ -4,12 +4,18 @@
 #include "TreeLayout.h"
 #include "BoardRenderer.h"
 #include "DisplayManager.h"
+#include "CompressedSolution.h"
+#include "SpatialIndex.h"
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
 /**
  * @brief 树渲染器，负责渲染树结构和节点
+ *
+ * 节点和连接线的范围放在空间索引中，布局改变后第一次绘制时重建；
+ * 每帧只查询与当前视图相交的节点和连接线，绘制开销与屏幕上的内容成正比，与树的大小无关。
  */
 class TreeRenderer
 {
@@ -20,7 +26,7 @@ public:
     TreeRenderer();
 
     /**
-     * @brief 设置树结构和布局
+     * @brief 设置树结构和布局（下次绘制时重建空间索引）
      * @param tree 树结构
      * @param layout 布局信息
      */
@@ -73,6 +79,19 @@ public:
      */
     DisplayManager *getDisplayManager() const;
 
+    /**
+     * @brief 设置单链折叠信息，折叠了节点的边以另一种颜色绘制并在中点显示链长标记
+     * @param compression 树对应的折叠视图，nullptr表示不显示
+     */
+    void setChainCompression(const CompressedSolution *compression);
+
+    /**
+     * @brief 查找位于指定世界坐标处的链长标记
+     * @param worldPos 世界坐标
+     * @return 标记所在边的下端节点索引，没有时返回-1
+     */
+    int findChainBadge(const sf::Vector2f &worldPos);
+
     /**
      * @brief 获取当前显示的最后一个节点的位置（用于居中显示）
      * @return 当前节点位置
@@ -86,8 +105,74 @@ private:
     DisplayManager *m_displayManager;               // 显示管理器
 
     sf::Color m_connectionColor;      // 连接线颜色
+    sf::Color m_mergedEdgeColor;      // DAG合并边颜色
+    sf::Color m_chainEdgeColor;       // 折叠了单链的边的颜色
     float m_connectionWidth;          // 连接线宽度
     std::vector<int> m_highlightPath; // 高亮路径
+    std::vector<char> m_inHighlight;  // 按节点索引标记是否在高亮路径中
+
+    const CompressedSolution *m_compression; // 单链折叠信息
+    sf::Font m_font;                         // 链长标记字体
+    bool m_fontLoaded;                       // 字体是否已加载
+
+    /**
+     * @brief 空间索引中的一条连接线
+     */
+    struct IndexedEdge
+    {
+        int from;    // 上端节点
+        int to;      // 下端节点
+        bool merged; // 是否为DAG合并边
+    };
+
+    SpatialIndex m_nodeIndex;            // 节点范围的空间索引（编号为节点索引）
+    SpatialIndex m_edgeIndex;            // 连接线范围的空间索引（编号为m_edges中的序号）
+    std::vector<IndexedEdge> m_edges;    // 已索引的连接线
+    const TreeLayout *m_indexedLayout;   // 空间索引对应的布局（nullptr表示需要重建）
+    uint64_t m_indexedRevision;          // 空间索引对应的布局版本
+    size_t m_indexedChanges;             // 已并入空间索引的增量布局改动数
+    std::vector<int> m_nodeItems;        // 每个节点在m_nodeIndex中的条目序号（-1表示未索引）
+    std::vector<int> m_parentEdgeItems;  // 每个节点到父节点的连接线在m_edgeIndex中的条目序号
+    std::vector<int> m_mergedEdgeItems;  // 每条DAG合并边在m_edgeIndex中的条目序号
+    std::vector<int> m_mergedEdgeStart;  // 每个节点的合并边在m_mergedEdgeList中的起点（多一个哨兵）
+    std::vector<int> m_mergedEdgeList;   // 按端点分组的合并边序号
+    std::vector<int> m_nodesInView;      // 本帧视图中的节点
+    std::vector<int> m_edgesInView;      // 本帧视图中的连接线
+    sf::VertexArray m_boardVertices;     // 本帧所有棋盘的矩形（每帧清空后重用容量）
+
+    /**
+     * @brief 布局改变后更新节点和连接线的空间索引
+     *
+     * 整体布局后重建一次；增量布局中只把新放置或移动的节点并入索引，动态桶变大后才整体重建
+     */
+    void updateSpatialIndex();
+
+    /**
+     * @brief 把增量放置或移动的节点及与它相连的连接线重新加入空间索引
+     * @param index 节点索引
+     */
+    void reindexNode(int index);
+
+    /**
+     * @brief 把一条连接线加入空间索引，替换item原来指向的条目
+     * @param from 上端节点
+     * @param to 下端节点
+     * @param merged 是否为DAG合并边
+     * @param item 该连接线的条目序号（-1表示尚未索引），返回新序号
+     */
+    void indexEdge(int from, int to, bool merged, int &item);
+
+    /**
+     * @brief 计算连接线的两个端点
+     *
+     * 分层布局从上端节点底部中点连到下端节点顶部中点，径向布局连接两者中心
+     */
+    void getEdgeEndpoints(int from, int to, sf::Vector2f &start, sf::Vector2f &end) const;
+
+    /**
+     * @brief 查询范围的外扩量（覆盖高亮边框和链长标记）
+     */
+    float getQueryMargin() const;
 
     /**
      * @brief 绘制连接线
@@ -95,6 +180,24 @@ private:
      */
     void drawConnections(sf::RenderWindow &window);
 
+    /**
+     * @brief 绘制链长标记
+     * @param window 渲染窗口
+     */
+    void drawChainBadges(sf::RenderWindow &window);
+
+    /**
+     * @brief 计算链长标记的范围（位于边的中点）
+     * @param index 边的下端节点索引
+     * @return 标记的世界坐标范围
+     */
+    sf::FloatRect getChainBadgeBounds(int index) const;
+
+    /**
+     * @brief 边的两端是否都已显示
+     */
+    bool isEdgeVisible(int parentIndex, int index) const;
+
     /**
      * @brief 绘制节点
      * @param window 渲染窗口
@@ -109,10 +212,10 @@ private:
 
     /**
      * @brief 获取节点渲染颜色
-     * @param node 节点
+     * @param node 节点句柄
      * @return 渲染颜色
      */
-    sf::Color getNodeColor(TreeNode *node) const;
+    sf::Color getNodeColor(FlatNode node) const;
 
     /**
      * @brief 判断节点是否在高亮路径中
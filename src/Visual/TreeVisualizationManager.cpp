@@ -6,9 +6,12 @@
 #include "../Visual/CanvasView.h"
 #include "../Visual/DisplayManager.h"
 #include "../Visual/BoardRenderer.h"
+#include "../Visual/TreeCache.h"
+#include "../Visual/CompressedSolution.h"
 #include "../Interaction/InteractionManager.h"
 #include "../Interaction/CommandRegistrar.h"
 #include <cmath>
+#include <filesystem>
 #include <iostream>
 
 /**
@@ -19,6 +22,19 @@
 TreeVisualizationManager::TreeVisualizationManager(sf::RenderWindow& window, const sf::Vector2f& windowSize)
     : window_(window)
     , windowSize_(windowSize)
+    , solution_(nullptr)
+    , builtRecords_(0)
+    , layoutDirty_(false)
+    , radialDirty_(false)
+    , dagMode_(false)
+    , incrementalMode_(true)
+    , radialMode_(false)
+    , compressedMode_(false)
+    , revealedNodes_(0)
+    , cacheEnabled_(false)
+    , layoutCached_(false)
+    , cacheKey_(0)
+    , layoutParametersHash_(0)
     , initialized_(false)
     , lastNodePosition_(0, 0)
     , shouldCenterOnNodeChange_(true) {
@@ -30,11 +46,23 @@ TreeVisualizationManager::TreeVisualizationManager(sf::RenderWindow& window, con
 TreeVisualizationManager::~TreeVisualizationManager() {
 }
 
+/**
+ * @brief 设置是否以DAG形式显示
+ * @param enabled 是否启用
+ */
+void TreeVisualizationManager::setDagMode(bool enabled) {
+    dagMode_ = enabled;
+}
+
 /**
  * @brief 运行树可视化主循环
  * @param solution 解决方案数据
  */
 void TreeVisualizationManager::run(const ISolution& solution) {
+    if (!waitForFirstRecord(solution)) {
+        window_.setView(window_.getDefaultView());
+        return;
+    }
     initialize(solution);
     
     sf::Clock clock;
@@ -72,6 +100,45 @@ void TreeVisualizationManager::run(const ISolution& solution) {
     window_.setView(window_.getDefaultView());
 }
 
+/**
+ * @brief 跟随模式下等待求解器写出第一条记录，期间照常处理窗口事件
+ * @param solution 解决方案数据
+ * @return 记录已到达返回true；窗口关闭、按B返回或加载已结束仍没有记录时返回false
+ */
+bool TreeVisualizationManager::waitForFirstRecord(const ISolution& solution) {
+    if (solution.size() > 0) {
+        return true;
+    }
+    
+    std::cout << "Waiting for the solver to write the first record (press B to return)..." << std::endl;
+    while (window_.isOpen()) {
+        sf::Event event;
+        while (window_.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window_.close();
+                return false;
+            }
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::B) {
+                std::cout << "Returning to Problem Editor..." << std::endl;
+                return false;
+            }
+        }
+        
+        if (solution.size() > 0) {
+            return true;
+        }
+        if (solution.isComplete()) {
+            std::cerr << "No records were loaded, returning to Problem Editor" << std::endl;
+            return false;
+        }
+        
+        // 帧率限制使这里按帧轮询，不占满CPU
+        window_.clear(sf::Color::Black);
+        window_.display();
+    }
+    return false;
+}
+
 /**
  * @brief 处理事件
  * @param event SFML事件
@@ -92,6 +159,31 @@ bool TreeVisualizationManager::handleEvent(const sf::Event& event) {
         return true; // 返回true表示需要返回ProblemEditor
     }
     
+    // 处理L键切换增量布局/整体布局
+    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::L) {
+        toggleIncrementalLayout();
+        return false;
+    }
+    
+    // 处理P键切换径向布局/分层布局
+    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::P) {
+        toggleRadialLayout();
+        return false;
+    }
+    
+    // 处理U键切换折叠单链的压缩视图
+    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::U) {
+        toggleCompressedView();
+        return false;
+    }
+    
+    // 压缩视图下左键点击链长标记展开该链
+    if (compressedMode_ && event.type == sf::Event::MouseButtonPressed &&
+        event.mouseButton.button == sf::Mouse::Left &&
+        expandChainAt(sf::Vector2f(event.mouseButton.x, event.mouseButton.y))) {
+        return false;
+    }
+    
     // 处理CanvasView事件（缩放和平移）
     canvasView_->handleEvent(event);
     
@@ -113,9 +205,15 @@ bool TreeVisualizationManager::handleEvent(const sf::Event& event) {
 void TreeVisualizationManager::update(sf::Time deltaTime) {
     if (!initialized_) return;
     
+    // 流式加载时把新到达的记录并入树
+    growTree();
+
     // 更新显示管理器（用于自动播放）
     displayManager_->updateAutoPlay(deltaTime);
     
+    // 新显示的节点并入增量布局
+    syncIncrementalLayout();
+    
     // 更新CanvasView
     canvasView_->update();
     
@@ -170,11 +268,8 @@ void TreeVisualizationManager::initialize(const ISolution& solution) {
 void TreeVisualizationManager::setupTreeRendering(const ISolution& solution) {
     std::cout << "Entering tree visualization mode\n";
     
-    // 构建树结构
+    solution_ = &solution;
     treeBuilder_ = std::make_unique<TreeBuilder>();
-    tree_ = std::move(treeBuilder_->buildTree(solution));
-    
-    std::cout << treeBuilder_->getBuildStats() << std::endl;
     
     // 创建BoardRenderer
     boardRenderer_ = std::make_unique<BoardRenderer>();
@@ -184,31 +279,77 @@ void TreeVisualizationManager::setupTreeRendering(const ISolution& solution) {
     // 在TreeView中显示panel
     boardRenderer_->setShowValuePanel(true);
     
-    // 计算布局
-    treeLayout_ = std::make_unique<TreeLayout>();
-    treeLayout_->setTree(tree_.get());
+    if (tree_ && treeLayout_ && solution.isComplete()) {
+        // 会话缓存中的树和布局，直接复用
+        builtRecords_ = solution.size();
+        layoutCached_ = true;
+        std::cout << "Reusing tree and layout from session cache (" << tree_->size() << " nodes)" << std::endl;
+    } else {
+        // 根据BoardRenderer的实际大小设置布局参数，参数同时决定布局缓存的键
+        auto boardTotalSize = boardRenderer_->getTotalSize();
+        tree_.reset();
+        treeLayout_ = std::make_shared<TreeLayout>();
+        treeLayout_->setLayoutParameters(250.0f, 200.0f, boardTotalSize.x, boardTotalSize.y);
+        treeLayout_->setPosition(100, 50);
+        layoutParametersHash_ = TreeCache::hashLayoutParameters(250.0f, 200.0f, boardTotalSize.x, boardTotalSize.y,
+                                                                sf::Vector2f(100, 50), dagMode_);
+        
+        if (!restoreFromCache(solution)) {
+            // 构建树结构：数据已完整时一次构建，流式加载时先用已到达的记录构建，之后每帧增量扩展
+            if (dagMode_ && solution.isComplete()) {
+                // 合并状态相同的记录，重复展开的边以合并边的形式保留
+                TranspositionIndex transpositions(solution);
+                std::cout << transpositions.getStats() << std::endl;
+                tree_ = treeBuilder_->buildDagTree(solution, transpositions);
+                builtRecords_ = solution.size();
+            } else if (solution.isComplete()) {
+                tree_ = std::move(treeBuilder_->buildTree(solution));
+                builtRecords_ = solution.size();
+            } else {
+                tree_ = std::make_shared<Tree>(&solution);
+                builtRecords_ = treeBuilder_->extendTree(*tree_, solution, 0);
+            }
+            
+            // 计算布局；流式加载时默认显示增量布局，整体布局推迟到加载结束或切换到整体布局时
+            treeLayout_->setTree(tree_.get());
+            if (solution.isComplete()) {
+                treeLayout_->calculateLayout();
+                storeLayoutCache();
+            } else {
+                layoutDirty_ = true;
+            }
+        }
+        
+        std::cout << treeBuilder_->getBuildStats() << std::endl;
+    }
     
-    // 根据BoardRenderer的实际大小设置布局参数
-    auto boardTotalSize = boardRenderer_->getTotalSize();
-    treeLayout_->setLayoutParameters(250.0f, 200.0f, boardTotalSize.x, boardTotalSize.y);
-    treeLayout_->setPosition(100, 50);
-    treeLayout_->calculateLayout();
+    if (!layoutDirty_) {
+        std::cout << "Layout calculation completed, overall size: "
+                  << treeLayout_->getTotalSize().x << " x "
+                  << treeLayout_->getTotalSize().y << std::endl;
+    }
     
-    std::cout << "Layout calculation completed, overall size: "
-              << treeLayout_->getTotalSize().x << " x "
-              << treeLayout_->getTotalSize().y << std::endl;
+    // 增量布局与整体布局使用相同的参数，初始只有空画布，节点显示时才放置
+    incrementalLayout_ = std::make_unique<TreeLayout>();
+    layoutNodeSize_ = boardRenderer_->getTotalSize();
+    incrementalLayout_->setLayoutParameters(250.0f, 200.0f, layoutNodeSize_.x, layoutNodeSize_.y);
+    incrementalLayout_->setPosition(100, 50);
+    incrementalLayout_->setTree(tree_.get());
+    incrementalLayout_->beginIncrementalLayout();
+    revealedNodes_ = 0;
     
     // 创建渲染器
+    displayTree_ = tree_;
     treeRenderer_ = std::make_unique<TreeRenderer>();
-    treeRenderer_->setTreeAndLayout(tree_.get(), treeLayout_.get());
+    treeRenderer_->setTreeAndLayout(tree_.get(), activeLayout());
     treeRenderer_->setBoardRenderer(std::move(boardRenderer_));
     treeRenderer_->setConnectionColor(sf::Color(200, 200, 200));
     
     // 创建CanvasView
     canvasView_ = std::make_unique<CanvasView>(windowSize_);
     
-    // 设置初始视图中心为树的中心
-    auto treeSize = treeLayout_->getTotalSize();
+    // 设置初始视图中心为树的中心（增量布局时为尚未展开的根附近）
+    auto treeSize = activeLayout()->getTotalSize();
     canvasView_->setCenter(sf::Vector2f(treeSize.x / 2, treeSize.y / 2));
     
     // 创建显示管理器
@@ -232,6 +373,339 @@ void TreeVisualizationManager::setupInteraction() {
         *interactionManager_,
         *canvasView_,
         *treeRenderer_,
-        tree_,
+        displayTree_,
         displayManager_.get());
 }
+
+/**
+ * @brief 将流式加载新到达的记录并入树、布局和显示管理器
+ */
+void TreeVisualizationManager::growTree() {
+    if (solution_->size() > builtRecords_) {
+        builtRecords_ = treeBuilder_->extendTree(*tree_, *solution_, builtRecords_);
+        displayManager_->growTotalNodes(tree_->size());
+        layoutDirty_ = true;
+        radialDirty_ = radialLayout_ != nullptr;
+    }
+    
+    refreshStaleLayouts(false);
+}
+
+/**
+ * @brief 刷新树增长后过期的整体布局和径向布局
+ *
+ * 两者都是O(N)的整体计算：加载期间只刷新正在显示的那一个并限制频率，
+ * 未显示的推迟到加载结束（此时立即刷新一次）或切换到该布局时
+ * @param immediate 是否忽略刷新间隔（切换布局时）
+ */
+void TreeVisualizationManager::refreshStaleLayouts(bool immediate) {
+    const sf::Time relayoutInterval = sf::milliseconds(250);
+    bool complete = solution_->isComplete();
+    bool due = immediate || layoutClock_.getElapsedTime() >= relayoutInterval;
+    bool showingLayered = !compressedMode_ && !radialMode_ && !incrementalMode_;
+    
+    if (layoutDirty_ && (complete || (showingLayered && due))) {
+        treeLayout_->setTree(tree_.get());
+        treeLayout_->calculateLayout();
+        layoutClock_.restart();
+        layoutDirty_ = false;
+        storeLayoutCache();
+    }
+    if (radialDirty_ && (complete || (radialMode_ && due))) {
+        radialLayout_->setTree(tree_.get());
+        radialLayout_->calculateLayout();
+        layoutClock_.restart();
+        radialDirty_ = false;
+    }
+}
+
+/**
+ * @brief 为新显示的节点增量计算位置
+ *
+ * 显示管理器按索引顺序显示节点，这里只处理上次同步之后新增的部分，
+ * 每个节点的代价是O(深度)；步退隐藏的节点保留位置，再次显示时不重新放置
+ */
+void TreeVisualizationManager::syncIncrementalLayout() {
+    // 压缩视图下显示进度是压缩索引，回到完整树时再补齐
+    if (!incrementalMode_ || compressedMode_) {
+        return;
+    }
+    
+    const FlatTree& flat = tree_->getFlatTree();
+    size_t visibleCount = displayManager_->getVisibleCount();
+    for (; revealedNodes_ < visibleCount; ++revealedNodes_) {
+        int index = static_cast<int>(revealedNodes_);
+        if (flat.contains(index)) {
+            incrementalLayout_->revealNode(index);
+        }
+    }
+}
+
+/**
+ * @brief 在增量布局和整体布局之间切换
+ */
+void TreeVisualizationManager::toggleIncrementalLayout() {
+    if (compressedMode_) {
+        std::cout << "Leave the compressed view (U) to change the layout" << std::endl;
+        return;
+    }
+    incrementalMode_ = !incrementalMode_;
+    radialMode_ = false;
+    if (incrementalMode_) {
+        syncIncrementalLayout();
+    }
+    refreshStaleLayouts(true);
+    applyActiveLayout();
+    std::cout << (incrementalMode_ ? "Incremental layout" : "Full layout") << std::endl;
+}
+
+/**
+ * @brief 在径向布局和分层布局之间切换
+ */
+void TreeVisualizationManager::toggleRadialLayout() {
+    if (compressedMode_) {
+        std::cout << "Leave the compressed view (U) to change the layout" << std::endl;
+        return;
+    }
+    radialMode_ = !radialMode_;
+    if (radialMode_ && !radialLayout_) {
+        sf::Clock clock;
+        radialLayout_ = std::make_unique<TreeLayout>();
+        radialLayout_->setLayoutParameters(250.0f, 200.0f, layoutNodeSize_.x, layoutNodeSize_.y);
+        radialLayout_->setPosition(100, 50);
+        radialLayout_->setLayoutMode(LayoutMode::Radial);
+        radialLayout_->setTree(tree_.get());
+        radialLayout_->calculateLayout();
+        std::cout << "Radial layout computed in " << clock.getElapsedTime().asMilliseconds() << " ms, overall size: "
+                  << radialLayout_->getTotalSize().x << " x " << radialLayout_->getTotalSize().y << std::endl;
+    }
+    refreshStaleLayouts(true);
+    applyActiveLayout();
+    std::cout << (radialMode_ ? "Radial layout" : "Layered layout") << std::endl;
+}
+
+/**
+ * @brief 在压缩视图和完整树之间切换
+ *
+ * 压缩视图只含根、叶子和分叉节点，每条最长单链折叠成一条带链长标记的边；
+ * 显示进度按原树索引换算，切换前后停在同一位置
+ */
+void TreeVisualizationManager::toggleCompressedView() {
+    if (!compressedMode_ && !getCompleteTree()) {
+        std::cout << "Compressed view is available once all records are loaded" << std::endl;
+        return;
+    }
+    
+    size_t progress = originalProgress();
+    compressedMode_ = !compressedMode_;
+    if (compressedMode_) {
+        sf::Clock clock;
+        compressedSolution_ = std::make_unique<CompressedSolution>(*tree_);
+        rebuildCompressedTree();
+        std::cout << "Compressed view: " << compressedTree_->size() << " of " << tree_->size() << " nodes kept in "
+                  << clock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+    } else {
+        displayTree_ = tree_;
+        compressedLayout_.reset();
+        compressedTree_.reset();
+        compressedSolution_.reset();
+    }
+    restoreProgress(progress);
+    syncIncrementalLayout();
+    
+    treeRenderer_->clearHighlightPath();
+    treeRenderer_->setChainCompression(compressedSolution_.get());
+    applyActiveLayout();
+    std::cout << (compressedMode_ ? "Compressed view (click a chain badge to expand it)" : "Full tree") << std::endl;
+}
+
+/**
+ * @brief 由压缩解决方案重建压缩树和布局
+ */
+void TreeVisualizationManager::rebuildCompressedTree() {
+    TreeBuilder builder;
+    compressedTree_ = builder.buildTree(*compressedSolution_);
+    
+    // 两端都保留的合并边映射到压缩索引，端点被折叠的合并边不显示
+    for (const auto& [from, to] : tree_->getMergedEdges()) {
+        int compressedFrom = compressedSolution_->compressedIndex(from);
+        int compressedTo = compressedSolution_->compressedIndex(to);
+        if (compressedFrom >= 0 && compressedTo >= 0) {
+            compressedTree_->addMergedEdge(compressedFrom, compressedTo);
+        }
+    }
+    
+    compressedLayout_ = std::make_unique<TreeLayout>();
+    compressedLayout_->setLayoutParameters(250.0f, 200.0f, layoutNodeSize_.x, layoutNodeSize_.y);
+    compressedLayout_->setPosition(100, 50);
+    compressedLayout_->setTree(compressedTree_.get());
+    compressedLayout_->calculateLayout();
+    displayTree_ = compressedTree_;
+}
+
+/**
+ * @brief 展开窗口坐标处链长标记对应的单链
+ * @param windowPos 鼠标的窗口坐标
+ * @return 点中了标记返回true
+ */
+bool TreeVisualizationManager::expandChainAt(const sf::Vector2f& windowPos) {
+    int index = treeRenderer_->findChainBadge(canvasView_->windowToWorld(windowPos));
+    if (index < 0) {
+        return false;
+    }
+    
+    // 展开后保留节点重新编号，显示进度按原树索引保持不变
+    int hidden = compressedSolution_->hiddenCount(index);
+    size_t progress = originalProgress();
+    compressedSolution_->expandChain(index);
+    rebuildCompressedTree();
+    restoreProgress(progress);
+    
+    treeRenderer_->clearHighlightPath();
+    treeRenderer_->setTreeAndLayout(compressedTree_.get(), compressedLayout_.get());
+    std::cout << "Expanded a chain of " << hidden << " nodes" << std::endl;
+    return true;
+}
+
+/**
+ * @brief 显示进度对应的原树索引数
+ * @return 已显示的原树索引数（压缩视图下为最后显示的保留节点之前的全部索引）
+ */
+size_t TreeVisualizationManager::originalProgress() const {
+    size_t visible = displayManager_->getVisibleCount();
+    if (!compressedMode_ || visible == 0) {
+        return visible;
+    }
+    return static_cast<size_t>(compressedSolution_->originalIndex(static_cast<int>(visible) - 1)) + 1;
+}
+
+/**
+ * @brief 按原树索引恢复显示进度
+ * @param progress 已显示的原树索引数（压缩视图下显示其中保留的节点）
+ */
+void TreeVisualizationManager::restoreProgress(size_t progress) {
+    size_t count = progress;
+    if (compressedMode_) {
+        // 保留节点按原索引升序编号，数出原索引小于progress的个数
+        count = 0;
+        while (count < compressedSolution_->size() &&
+               static_cast<size_t>(compressedSolution_->originalIndex(static_cast<int>(count))) < progress) {
+            ++count;
+        }
+    }
+    
+    displayManager_->setTotalNodes(displayTree_->size());
+    for (size_t i = 0; i < count; ++i) {
+        displayManager_->nextStep();
+    }
+}
+
+/**
+ * @brief 当前显示的布局
+ * @return 压缩、径向、增量或整体布局
+ */
+TreeLayout* TreeVisualizationManager::activeLayout() const {
+    if (compressedMode_) {
+        return compressedLayout_.get();
+    }
+    if (radialMode_) {
+        return radialLayout_.get();
+    }
+    return incrementalMode_ ? incrementalLayout_.get() : treeLayout_.get();
+}
+
+/**
+ * @brief 让渲染器使用当前显示的布局
+ */
+void TreeVisualizationManager::applyActiveLayout() {
+    treeRenderer_->setTreeAndLayout(displayTree_.get(), activeLayout());
+    
+    // 各布局中当前节点位置不同，切换后重新居中
+    lastNodePosition_ = sf::Vector2f(-1, -1);
+}
+
+/**
+ * @brief 设置布局缓存的键
+ * @param sourceKey 解决方案文件键
+ */
+void TreeVisualizationManager::setCacheKey(uint64_t sourceKey) {
+    cacheKey_ = sourceKey;
+    cacheEnabled_ = true;
+}
+
+/**
+ * @brief 使用之前构建好的树和布局
+ * @param tree 由同一解决方案完整构建的树
+ * @param layout 已计算的布局
+ */
+void TreeVisualizationManager::setPrebuiltTree(std::shared_ptr<Tree> tree, std::shared_ptr<TreeLayout> layout) {
+    tree_ = std::move(tree);
+    treeLayout_ = std::move(layout);
+}
+
+/**
+ * @brief 获取完整的树
+ * @return 所有记录都已并入树且布局已刷新时返回树，否则返回nullptr（加载出错时同样返回nullptr）
+ */
+std::shared_ptr<Tree> TreeVisualizationManager::getCompleteTree() const {
+    bool complete = solution_ && solution_->isComplete() && !solution_->hasFailed() &&
+                    builtRecords_ >= solution_->size() && !layoutDirty_;
+    return complete ? tree_ : nullptr;
+}
+
+/**
+ * @brief 获取与完整树对应的布局
+ * @return 布局，树不完整时返回nullptr
+ */
+std::shared_ptr<TreeLayout> TreeVisualizationManager::getCompleteLayout() const {
+    return getCompleteTree() ? treeLayout_ : nullptr;
+}
+
+/**
+ * @brief 从布局缓存恢复树和布局
+ * @param solution 解决方案数据
+ * @return 命中缓存返回true
+ */
+bool TreeVisualizationManager::restoreFromCache(const ISolution& solution) {
+    std::error_code ec;
+    std::string path = TreeCache::layoutCachePath(cacheKey_, layoutParametersHash_);
+    if (!cacheEnabled_ || !solution.isComplete() || !std::filesystem::exists(path, ec)) {
+        return false;
+    }
+    
+    try {
+        sf::Clock clock;
+        TreeCache::CachedLayout cached(path, cacheKey_, layoutParametersHash_);
+        if (cached.size() > solution.size()) {
+            throw std::runtime_error("cached tree does not match the solution");
+        }
+        tree_ = treeBuilder_->buildTree(solution, cached.treeParents(), cached.root());
+        cached.restoreMergedEdges(*tree_);
+        treeLayout_->setTree(tree_.get());
+        treeLayout_->setNodePositions(cached.positions(), cached.size());
+        builtRecords_ = solution.size();
+        layoutCached_ = true;
+        std::cout << "Restored tree and layout from " << path << " in "
+                  << clock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Ignoring layout cache: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/**
+ * @brief 记录全部到达且布局完成后写入布局缓存（每次打开只写一次，加载出错时不写）
+ */
+void TreeVisualizationManager::storeLayoutCache() {
+    if (!cacheEnabled_ || layoutCached_ || !solution_->isComplete() || solution_->hasFailed()) {
+        return;
+    }
+    
+    try {
+        TreeCache::storeLayout(*tree_, *treeLayout_, cacheKey_, layoutParametersHash_);
+        layoutCached_ = true;
+    } catch (const std::exception& e) {
+        std::cerr << "Cannot store layout cache: " << e.what() << std::endl;
+    }
+}
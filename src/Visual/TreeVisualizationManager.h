@@ -1,6 +1,7 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <memory>
 #include "../Core/TreeNode.h"
 #include "../Parser/Solution.h"
@@ -18,6 +19,7 @@ class CanvasView;
 class DisplayManager;
 class InteractionManager;
 class BoardRenderer;
+class CompressedSolution;
 
 /**
  * @brief 树可视化管理器
@@ -45,6 +47,38 @@ public:
      */
     void run(const ISolution& solution);
 
+    /**
+     * @brief 设置是否以DAG形式显示（合并状态相同的记录），须在run之前调用
+     * @param enabled 是否启用
+     */
+    void setDagMode(bool enabled);
+
+    /**
+     * @brief 启用树与布局缓存，须在run之前调用
+     *
+     * 记录完整时先按文件键和布局参数查找缓存，命中则直接映射恢复树和节点位置；
+     * 否则正常构建和布局，全部记录到达后写入缓存。
+     * @param sourceKey 解决方案文件键（TreeCache::fileKey）
+     */
+    void setCacheKey(uint64_t sourceKey);
+
+    /**
+     * @brief 使用之前构建好的树和布局（会话缓存），须在run之前调用
+     * @param tree 由同一解决方案完整构建的树
+     * @param layout 已计算的布局
+     */
+    void setPrebuiltTree(std::shared_ptr<Tree> tree, std::shared_ptr<TreeLayout> layout);
+
+    /**
+     * @brief 获取树（所有记录都已并入树且布局已刷新时有效，否则返回nullptr）
+     */
+    std::shared_ptr<Tree> getCompleteTree() const;
+
+    /**
+     * @brief 获取与getCompleteTree对应的布局（无效时返回nullptr）
+     */
+    std::shared_ptr<TreeLayout> getCompleteLayout() const;
+
     /**
      * @brief 处理事件
      * @param event SFML事件
@@ -64,6 +98,13 @@ public:
     void draw();
 
 private:
+    /**
+     * @brief 等待第一条记录到达（跟随模式下求解器可能尚未写出记录），期间照常处理窗口事件
+     * @param solution 解决方案数据
+     * @return 记录已到达返回true，窗口关闭、按B返回或加载结束仍没有记录时返回false
+     */
+    bool waitForFirstRecord(const ISolution& solution);
+
     /**
      * @brief 初始化管理器
      * @param solution 解决方案数据
@@ -81,6 +122,82 @@ private:
      */
     void setupInteraction();
 
+    /**
+     * @brief 将流式加载新到达的记录并入树、布局和显示管理器
+     */
+    void growTree();
+
+    /**
+     * @brief 刷新过期的整体布局和径向布局（加载期间只刷新正在显示的布局）
+     * @param immediate 是否忽略刷新间隔（切换布局时）
+     */
+    void refreshStaleLayouts(bool immediate);
+
+    /**
+     * @brief 为显示管理器新显示的节点增量计算位置（增量布局模式下每帧调用）
+     */
+    void syncIncrementalLayout();
+
+    /**
+     * @brief 在增量布局和整体布局之间切换
+     */
+    void toggleIncrementalLayout();
+
+    /**
+     * @brief 在径向布局和分层布局之间切换（径向布局首次使用时计算，不重建树）
+     */
+    void toggleRadialLayout();
+
+    /**
+     * @brief 在折叠单链的压缩视图和完整树之间切换（须所有记录都已并入树）
+     */
+    void toggleCompressedView();
+
+    /**
+     * @brief 由压缩解决方案重建压缩树和布局，开销与保留节点数成正比
+     */
+    void rebuildCompressedTree();
+
+    /**
+     * @brief 展开窗口坐标处链长标记对应的单链
+     * @param windowPos 鼠标的窗口坐标
+     * @return 点中了标记返回true
+     */
+    bool expandChainAt(const sf::Vector2f& windowPos);
+
+    /**
+     * @brief 显示进度对应的原树索引数（压缩视图下换算回原树）
+     */
+    size_t originalProgress() const;
+
+    /**
+     * @brief 按原树索引恢复显示进度（压缩视图下换算为保留节点数）
+     * @param progress 已显示的原树索引数
+     */
+    void restoreProgress(size_t progress);
+
+    /**
+     * @brief 当前显示的布局
+     */
+    TreeLayout* activeLayout() const;
+
+    /**
+     * @brief 让渲染器使用当前显示的布局并在下一帧重新居中
+     */
+    void applyActiveLayout();
+
+    /**
+     * @brief 从布局缓存恢复树和布局
+     * @param solution 解决方案数据
+     * @return 命中缓存返回true
+     */
+    bool restoreFromCache(const ISolution& solution);
+
+    /**
+     * @brief 记录全部到达且布局完成后写入布局缓存
+     */
+    void storeLayoutCache();
+
     sf::RenderWindow& window_;              // SFML渲染窗口引用
     const sf::Vector2f windowSize_;         // 窗口大小
     
@@ -91,9 +208,31 @@ private:
     std::unique_ptr<InteractionManager> interactionManager_; // 交互管理器
     
     std::shared_ptr<Tree> tree_;                        // 树结构
-    std::unique_ptr<TreeLayout> treeLayout_;            // 树布局
+    std::shared_ptr<Tree> displayTree_;                 // 当前显示的树（tree_或压缩树）
+    std::unique_ptr<CompressedSolution> compressedSolution_; // 折叠单链后的树视图
+    std::shared_ptr<Tree> compressedTree_;              // 由压缩视图构建的树
+    std::unique_ptr<TreeLayout> compressedLayout_;      // 压缩树的分层布局
+    std::shared_ptr<TreeLayout> treeLayout_;            // 树布局
+    std::unique_ptr<TreeLayout> incrementalLayout_;     // 随显示进度增长的增量布局
+    std::unique_ptr<TreeLayout> radialLayout_;          // 径向布局（首次切换时计算）
+    sf::Vector2f layoutNodeSize_;                       // 布局使用的节点尺寸（棋盘实际大小）
     std::unique_ptr<BoardRenderer> boardRenderer_;      // 棋盘渲染器
     
+    const ISolution* solution_;                         // 当前显示的解决方案
+    size_t builtRecords_;                               // 已并入树的记录数
+    bool layoutDirty_;                                  // 树已增长但整体布局尚未刷新
+    bool radialDirty_;                                  // 树已增长但径向布局尚未刷新
+    bool dagMode_;                                      // 是否合并重复状态显示为DAG
+    bool incrementalMode_;                              // 是否显示增量布局
+    bool radialMode_;                                   // 是否显示径向布局
+    bool compressedMode_;                               // 是否显示折叠单链的压缩视图
+    size_t revealedNodes_;                              // 已并入增量布局的显示进度
+    bool cacheEnabled_;                                 // 是否使用树与布局缓存
+    bool layoutCached_;                                 // 当前布局是否已在缓存中
+    uint64_t cacheKey_;                                 // 解决方案文件键
+    uint64_t layoutParametersHash_;                     // 布局参数哈希
+    sf::Clock layoutClock_;                             // 距上次刷新布局的时间
+
     bool initialized_;                                  // 是否已初始化
     sf::Vector2f lastNodePosition_;                     // 上一次的节点位置
     bool shouldCenterOnNodeChange_;                     // 是否应该在节点变化时居中
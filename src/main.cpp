@@ -6,15 +6,39 @@
 
 #include "Core/PuzzleState.h"
 #include "Parser/Solution.h"
+#include "Parser/BinarySolution.h"
 #include "Parser/ProblemLoader.h"
+#include "Parser/LoadBenchmark.h"
 #include "Visual/TreeVisualizationManager.h"
 #include "Visual/AnimationVisualizationManager.h"
 #include "Visual/ProblemEditor.h"
+#include "Visual/LayoutBenchmark.h"
 
-int main()
+int main(int argc, char *argv[])
 {
     try
     {
+        // 命令行转换模式: --convert solution.txt solution.npsb
+        if (argc == 4 && std::string(argv[1]) == "--convert")
+        {
+            convertSolutionToBinary(argv[2], argv[3]);
+            return 0;
+        }
+
+        // 加载基准测试: --bench-load solution.txt [repeat]
+        if ((argc == 3 || argc == 4) && std::string(argv[1]) == "--bench-load")
+        {
+            runLoadBenchmark(argv[2], argc == 4 ? std::stoul(argv[3]) : 3);
+            return 0;
+        }
+
+        // 布局基准测试: --bench-layout [maxNodes]
+        if ((argc == 2 || argc == 3) && std::string(argv[1]) == "--bench-layout")
+        {
+            runLayoutBenchmark(argc == 3 ? std::stoul(argv[2]) : 10000000);
+            return 0;
+        }
+
         // 初始化SFML窗口
         sf::RenderWindow window(sf::VideoMode(1600, 1000), "N-Puzzle Visualization");
         window.setFramerateLimit(60);
@@ -0,0 +1,75 @@
+// SolutionValidator的根节点与成环检查测试（无第三方依赖，失败时assert中止）
+// 在仓库根目录构建并运行：
+//   g++ -std=c++17 -Isrc tests/SolutionValidatorTest.cpp src/Parser/SolutionValidator.cpp \
+//       src/Parser/SolutionScanner.cpp src/Core/PuzzleState.cpp src/Core/Zobrist.cpp -lpthread -o validator_test
+//   ./validator_test
+#include "Parser/SolutionScanner.h"
+#include "Parser/SolutionValidator.h"
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    // 3x3棋盘上互相只差一次空格移动的三个状态：ROOT -> LEFT，LEFT <-> BLANK_FIRST
+    const std::vector<int> ROOT = {1, 2, 0, 3, 4, 5, 6, 7, 8};
+    const std::vector<int> LEFT = {1, 0, 2, 3, 4, 5, 6, 7, 8};
+    const std::vector<int> BLANK_FIRST = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+
+    void add(SolutionColumns &columns, const std::vector<int> &tiles, int parent, int g)
+    {
+        columns.states.emplace_back(tiles);
+        columns.parents.push_back(parent);
+        columns.g.push_back(g);
+        columns.h.push_back(0);
+        columns.f.push_back(g);
+    }
+
+    bool mentions(const ValidationReport &report, const char *text)
+    {
+        return report.firstError.find(text) != std::string::npos;
+    }
+
+    void testValidChainWithForwardParent()
+    {
+        // 父节点出现在子节点之后也是合法的
+        SolutionColumns columns;
+        add(columns, BLANK_FIRST, 2, 2);
+        add(columns, ROOT, -1, 0);
+        add(columns, LEFT, 1, 1);
+        ValidationReport report = SolutionValidator::validate(columns);
+        assert(report.ok());
+        assert(report.checked == 3);
+    }
+
+    void testMissingRoot()
+    {
+        SolutionColumns columns;
+        add(columns, LEFT, 1, 1);
+        add(columns, BLANK_FIRST, 0, 2);
+        ValidationReport report = SolutionValidator::validate(columns);
+        assert(!report.ok());
+        assert(mentions(report, "no root record"));
+    }
+
+    void testParentCycle()
+    {
+        // 有根节点，但记录1和2互为父节点，永远走不到根
+        SolutionColumns columns;
+        add(columns, ROOT, -1, 0);
+        add(columns, LEFT, 2, 1);
+        add(columns, BLANK_FIRST, 1, 2);
+        ValidationReport report = SolutionValidator::validate(columns);
+        assert(!report.ok());
+        assert(mentions(report, "cycle"));
+    }
+}
+
+int main()
+{
+    testValidChainWithForwardParent();
+    testMissingRoot();
+    testParentCycle();
+    std::cout << "SolutionValidator tests passed" << std::endl;
+    return 0;
+}